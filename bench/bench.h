@@ -0,0 +1,147 @@
+#ifndef SAN_BENCH_H
+#define SAN_BENCH_H
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Simulates a caller working on other data between the calls we measure, by touching
+ * one cache line of a buffer per call, which evicts our tables from the caches once the
+ * buffer outgrows them. The size in KiB is the benchmark argument, 0 keeps the caches hot.
+ */
+class Noise {
+  public:
+    explicit Noise(const benchmark::State &state)
+        : buffer(static_cast<size_t>(state.range(0)) * 1024 + 64) {}
+
+    void touch() {
+        position = position + 64 < buffer.size() ? position + 64 : 0;
+        benchmark::DoNotOptimize(++buffer[position]);
+    }
+
+  private:
+    std::vector<char> buffer;
+    size_t position = 0;
+};
+
+#define NOISE_ARGS Arg(0)->Arg(256)->Arg(4096)
+
+/**
+ * Reads hardware performance counters from construction (i.e., right before the loop we
+ * measure) to destruction, and reports them per value: cycles, instructions, branch
+ * misses, L1D read misses and the instructions per cycle. Only enabled if the environment
+ * variable SAN_PERF is set (e.g., SAN_PERF=1 sanbench), and only on Linux. Counters the
+ * kernel refuses, e.g., in containers or with a restrictive perf_event_paranoid, are
+ * omitted (with a warning on the first refusal), so the time is always reported.
+ */
+class PerfCounters {
+  public:
+    explicit PerfCounters(benchmark::State &state, size_t valuesPerIteration = 1)
+        : state(state), valuesPerIteration(valuesPerIteration) {
+#ifdef __linux__
+        auto enabled = getenv("SAN_PERF");
+        if (enabled == nullptr || *enabled == '\0' || strcmp(enabled, "0") == 0) {
+            return;
+        }
+        for (auto &event : events) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // counters are multiplexed if the CPU has too few of them, so we extrapolate
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            event.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (event.fd < 0) {
+                warn(event.name);
+            }
+        }
+        for (auto &event : events) {
+            if (event.fd >= 0) {
+                ioctl(event.fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(event.fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (auto &event : events) {
+            if (event.fd >= 0) {
+                ioctl(event.fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        auto values = static_cast<double>(state.iterations() * valuesPerIteration);
+        double counts[EVENTS] = {};
+        for (size_t i = 0; i < EVENTS; ++i) {
+            uint64_t data[3]; // value, time enabled, time running
+            if (events[i].fd < 0) {
+                continue;
+            }
+            if (read(events[i].fd, data, sizeof(data)) == sizeof(data) && data[2] != 0) {
+                counts[i] = static_cast<double>(data[0]) * data[1] / data[2];
+                state.counters[events[i].name] = counts[i] / values;
+            }
+            close(events[i].fd);
+        }
+        if (counts[0] != 0 && counts[1] != 0) {
+            state.counters["IPC"] = counts[1] / counts[0];
+        }
+#endif
+    }
+
+  private:
+#ifdef __linux__
+    struct Event {
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+        int fd;
+    };
+
+    static constexpr size_t EVENTS = 4;
+
+    // cycles and instructions first, for the IPC
+    Event events[EVENTS] = {
+        {"cycles/value", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1},
+        {"instructions/value", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, -1},
+        {"branch-misses/value", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, -1},
+        {"L1D-misses/value", PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+             PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+         -1},
+    };
+
+    static void warn(const char *name) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            fprintf(stderr, "perf_event_open failed for %s (%s), omitting such counters\n", name,
+                    strerror(errno));
+        }
+    }
+#endif
+
+    benchmark::State &state;
+    size_t valuesPerIteration;
+};
+
+#endif // SAN_BENCH_H
@@ -0,0 +1,442 @@
+#include "bench.h"
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <san.h>
+#include <sanEncoded.h>
+#include <string>
+#include <vector>
+
+// Every codec of the library against hexadecimal, decimal (std::to_chars/std::from_chars)
+// and unpadded base64 of the big-endian bytes, on the same values of several distributions,
+// one value per iteration. Besides the time per value, each benchmark reports the encoded
+// characters (bytes_per_second, chars/op) and the heap allocations per value (allocs/op).
+// Filter by width, codec or distribution, e.g., --benchmark_filter='decode64/.*/uniform'.
+
+using namespace san;
+
+using uint128_t = unsigned __int128;
+
+namespace {
+
+// heap allocations of the whole process, counted by the replaced operator new below
+size_t allocations = 0;
+
+} // namespace
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (auto memory = malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+namespace {
+
+enum class Distribution { TINY, NEGATIVE, UNIFORM, APPLICATION, SEQUENTIAL };
+
+const Distribution distributions[] = {Distribution::TINY, Distribution::NEGATIVE,
+                                      Distribution::UNIFORM, Distribution::APPLICATION,
+                                      Distribution::SEQUENTIAL};
+
+const char *name(Distribution distribution) {
+    switch (distribution) {
+    case Distribution::TINY:
+        return "tiny";
+    case Distribution::NEGATIVE:
+        return "negative";
+    case Distribution::UNIFORM:
+        return "uniform";
+    case Distribution::APPLICATION:
+        return "application";
+    default:
+        return "sequential";
+    }
+}
+
+constexpr uint128_t mask(size_t bits) {
+    return bits == 128 ? ~uint128_t() : (uint128_t(1) << bits) - 1;
+}
+
+/**
+ * A value of the kind usually stored in the given width, like in testApplications.cpp:
+ * the host part of a private network (24 bit), IPv4 addresses in network byte order (32),
+ * MAC addresses of a few vendors (48), Snowflake-style IDs (64) and random UUIDs (128).
+ */
+uint128_t application(size_t bits, std::mt19937_64 &random) {
+    switch (bits) {
+    case 24:
+        return random() % 1024;
+    case 32: {
+        // 10.0.0.0/8, 172.16.0.0/12, 192.168.0.0/16 and public addresses, little-endian
+        static const uint32_t networks[] = {0x0a, 0x10ac, 0xa8c0, 0};
+        static const uint32_t hosts[] = {0xffffff00, 0xfff00000, 0xffff0000, 0xffffffff};
+        auto network = random() % 4;
+        return networks[network] | (static_cast<uint32_t>(random()) & hosts[network]);
+    }
+    case 48: {
+        static const uint64_t ouis[] = {0x001b44, 0x2c5491, 0x3c5ab4, 0xf0def1};
+        return ouis[random() % 4] << 24 | (random() & 0xffffff);
+    }
+    case 64: {
+        // milliseconds since 2010 (in 2024), a worker and a sequence number
+        auto millis = 441'000'000'000 + random() % 10'000'000'000;
+        return millis << 22 | (random() % 32) << 12 | random() % 4096;
+    }
+    default: {
+        // version 4, variant 1
+        uint64_t ab = (random() & 0xffffffffffff0fff) | 0x4000;
+        uint64_t cd = (random() & 0x3fffffffffffffff) | 0x8000000000000000;
+        return uint128_t(ab) << 64 | cd;
+    }
+    }
+}
+
+/**
+ * The values to encode, as unsigned integers of the given width.
+ */
+std::vector<uint128_t> generate(size_t bits, Distribution distribution) {
+    std::mt19937_64 random(42);
+    std::vector<uint128_t> values(4096);
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint128_t value;
+        switch (distribution) {
+        case Distribution::TINY:
+            value = random() % 64;
+            break;
+        case Distribution::NEGATIVE:
+            value = -uint128_t(random() % 4096 + 1);
+            break;
+        case Distribution::UNIFORM:
+            value = uint128_t(random()) << 64 | random();
+            break;
+        case Distribution::APPLICATION:
+            value = application(bits, random);
+            break;
+        default:
+            value = 1'000'000 + i;
+        }
+        values[i] = value & mask(bits);
+    }
+    return values;
+}
+
+template <size_t Bits> struct San {
+    static constexpr const char *name = "san";
+
+    static char *encode(char *first, char *last, uint128_t value) {
+        if constexpr (Bits == 24) {
+            return encode24(first, last, static_cast<uint32_t>(value)).ptr;
+        } else if constexpr (Bits == 32) {
+            return encode32(first, last, static_cast<uint32_t>(value)).ptr;
+        } else if constexpr (Bits == 48) {
+            return encode48(first, last, static_cast<uint64_t>(value)).ptr;
+        } else if constexpr (Bits == 64) {
+            return encode64(first, last, static_cast<uint64_t>(value)).ptr;
+        } else {
+            auto ab = static_cast<uint64_t>(value >> 64);
+            return encode128(first, last, ab, static_cast<uint64_t>(value)).ptr;
+        }
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        ERROR ec;
+        if constexpr (Bits <= 32) {
+            uint32_t output;
+            ec = Bits == 24 ? decode24(first, last, output).ec : decode32(first, last, output).ec;
+            value = output;
+        } else if constexpr (Bits <= 64) {
+            uint64_t output;
+            ec = Bits == 48 ? decode48(first, last, output).ec : decode64(first, last, output).ec;
+            value = output;
+        } else {
+            std::pair<uint64_t, uint64_t> output;
+            ec = decode128(first, last, output).ec;
+            value = uint128_t(output.first) << 64 | output.second;
+        }
+        return ec == ERROR::OK;
+    }
+};
+
+// the std::string API of the library, i.e., including the allocation of the result, and
+// the unchecked decoders
+template <size_t Bits> struct SanString {
+    static constexpr const char *name = "sanString";
+
+    static char *encode(char *first, char *, uint128_t value) {
+        // the copy is what callers do with the result, and needed by the decode benchmark
+        std::string encoded;
+        if constexpr (Bits == 24) {
+            encoded = encode24(static_cast<uint32_t>(value));
+        } else if constexpr (Bits == 32) {
+            encoded = encode32(static_cast<uint32_t>(value));
+        } else if constexpr (Bits == 48) {
+            encoded = encode48(static_cast<uint64_t>(value));
+        } else if constexpr (Bits == 64) {
+            encoded = encode64(static_cast<uint64_t>(value));
+        } else {
+            encoded = encode128(static_cast<uint64_t>(value >> 64), static_cast<uint64_t>(value));
+        }
+        memcpy(first, encoded.data(), encoded.size());
+        return first + encoded.size();
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        std::string_view input(first, static_cast<size_t>(last - first));
+        if constexpr (Bits == 24) {
+            value = decode24(input);
+        } else if constexpr (Bits == 32) {
+            value = decode32(input);
+        } else if constexpr (Bits == 48) {
+            value = decode48(input);
+        } else if constexpr (Bits == 64) {
+            value = decode64(input);
+        } else {
+            auto output = decode128(input);
+            value = uint128_t(output.first) << 64 | output.second;
+        }
+        return true;
+    }
+};
+
+template <size_t Bits> struct SanInline {
+    static constexpr const char *name = "sanInline";
+
+    static char *encode(char *first, char *, uint128_t value) {
+        // like SanString, the copy is what callers do with the result
+        auto encoded = encodeInline<Bits>(static_cast<value_t<Bits>>(value));
+        memcpy(first, encoded.data(), encoded.capacity());
+        return first + encoded.size();
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        Encoded<Bits> encoded;
+        if (from_chars(first, last, encoded).ec != ERROR::OK) {
+            return false;
+        }
+        value = encoded.decode();
+        return true;
+    }
+};
+
+// 128-bit values are split into 64-bit parts, since std::to_chars does not take them portably
+struct Hex {
+    static constexpr const char *name = "hex";
+
+    static char *encode(char *first, char *last, uint128_t value) {
+        auto ab = static_cast<uint64_t>(value >> 64);
+        if (ab == 0) {
+            return std::to_chars(first, last, static_cast<uint64_t>(value), 16).ptr;
+        }
+        first = std::to_chars(first, last, ab, 16).ptr;
+        char digits[16];
+        auto end = std::to_chars(digits, digits + 16, static_cast<uint64_t>(value), 16).ptr;
+        auto length = static_cast<size_t>(end - digits);
+        memset(first, '0', 16 - length);
+        memcpy(first + 16 - length, digits, length);
+        return first + 16;
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        auto split = last - first > 16 ? last - 16 : first;
+        uint64_t ab = 0;
+        uint64_t cd = 0;
+        if (split != first && std::from_chars(first, split, ab, 16).ptr != split) {
+            return false;
+        }
+        auto res = std::from_chars(split, last, cd, 16);
+        if (res.ec != std::errc() || res.ptr != last) {
+            return false;
+        }
+        value = uint128_t(ab) << 64 | cd;
+        return true;
+    }
+};
+
+struct Decimal {
+    static constexpr const char *name = "decimal";
+
+    static constexpr uint64_t TEN19 = 10'000'000'000'000'000'000u;
+
+    static char *encode(char *first, char *last, uint128_t value) {
+        if (value >> 64 == 0) {
+            return std::to_chars(first, last, static_cast<uint64_t>(value)).ptr;
+        }
+        first = encode(first, last, value / TEN19);
+        char digits[19];
+        auto end = std::to_chars(digits, digits + 19, static_cast<uint64_t>(value % TEN19)).ptr;
+        auto length = static_cast<size_t>(end - digits);
+        memset(first, '0', 19 - length);
+        memcpy(first + 19 - length, digits, length);
+        return first + 19;
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        // up to 19 digits at a time, the first chunk taking the remainder
+        static const uint64_t powers[] = {1,
+                                          10,
+                                          100,
+                                          1'000,
+                                          10'000,
+                                          100'000,
+                                          1'000'000,
+                                          10'000'000,
+                                          100'000'000,
+                                          1'000'000'000,
+                                          10'000'000'000,
+                                          100'000'000'000,
+                                          1'000'000'000'000,
+                                          10'000'000'000'000,
+                                          100'000'000'000'000,
+                                          1'000'000'000'000'000,
+                                          10'000'000'000'000'000,
+                                          100'000'000'000'000'000,
+                                          1'000'000'000'000'000'000,
+                                          TEN19};
+        auto length = static_cast<size_t>(last - first);
+        auto end = first + ((length - 1) % 19 + 1);
+        value = 0;
+        for (; first != last; first = end, end += 19) {
+            uint64_t chunk;
+            auto res = std::from_chars(first, end, chunk);
+            if (res.ec != std::errc() || res.ptr != end) {
+                return false;
+            }
+            value = value * powers[end - first] + chunk;
+        }
+        return length != 0;
+    }
+};
+
+// unpadded base64 (RFC 4648) of the Bits / 8 big-endian bytes, as usually used for IDs
+template <size_t Bits> struct Base64 {
+    static constexpr const char *name = "base64";
+
+    static constexpr const char *alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // the bits the last character is padded with
+    static constexpr size_t PADDING = 6 * maxLength(Bits) - Bits;
+
+    static char *encode(char *first, char *, uint128_t value) {
+        for (size_t i = 1; i < maxLength(Bits); ++i) {
+            *first++ = alphabet[static_cast<size_t>(value >> (Bits - 6 * i)) & 63];
+        }
+        *first++ = alphabet[static_cast<size_t>(value << PADDING) & 63];
+        return first;
+    }
+
+    static bool decode(const char *first, const char *last, uint128_t &value) {
+        static const auto digits = [] {
+            std::array<uint8_t, 256> digits{};
+            digits.fill(64);
+            for (uint8_t i = 0; i < 64; ++i) {
+                digits[static_cast<uint8_t>(alphabet[i])] = i;
+            }
+            return digits;
+        }();
+        if (static_cast<size_t>(last - first) != maxLength(Bits)) {
+            return false;
+        }
+        uint8_t invalid = 0;
+        value = 0;
+        for (; first + 1 != last; ++first) {
+            auto digit = digits[static_cast<uint8_t>(*first)];
+            invalid |= digit;
+            value = value << 6 | digit;
+        }
+        auto digit = digits[static_cast<uint8_t>(*first)];
+        value = value << (6 - PADDING) | digit >> PADDING;
+        return ((invalid | digit) & 64) == 0 && (digit & ((1u << PADDING) - 1)) == 0;
+    }
+};
+
+void report(benchmark::State &state, size_t chars, size_t allocated) {
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(chars));
+    state.counters["chars/op"] = benchmark::Counter(chars, benchmark::Counter::kAvgIterations);
+    state.counters["allocs/op"] =
+        benchmark::Counter(allocated, benchmark::Counter::kAvgIterations);
+}
+
+template <size_t Bits, typename Codec>
+void encode(benchmark::State &state, Distribution distribution) {
+    auto values = generate(Bits, distribution);
+    char buffer[64];
+    size_t i = 0;
+    size_t chars = 0;
+    auto allocated = allocations;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto end = Codec::encode(buffer, buffer + sizeof(buffer), values[i++ % values.size()]);
+        chars += static_cast<size_t>(end - buffer);
+        benchmark::DoNotOptimize(end);
+        benchmark::ClobberMemory();
+    }
+    report(state, chars, allocations - allocated);
+}
+
+template <size_t Bits, typename Codec>
+void decode(benchmark::State &state, Distribution distribution) {
+    auto values = generate(Bits, distribution);
+    std::vector<char> encoded(values.size() * 64);
+    std::vector<const char *> ends(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto first = encoded.data() + 64 * i;
+        ends[i] = Codec::encode(first, first + 64, values[i]);
+    }
+    size_t i = 0;
+    size_t chars = 0;
+    auto allocated = allocations;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto index = i++ % values.size();
+        auto first = encoded.data() + 64 * index;
+        uint128_t value;
+        if (!Codec::decode(first, ends[index], value) || value != values[index]) {
+            state.SkipWithError("decoded a different value");
+            break;
+        }
+        chars += static_cast<size_t>(ends[index] - first);
+        benchmark::DoNotOptimize(value);
+    }
+    report(state, chars, allocations - allocated);
+}
+
+template <size_t Bits, typename Codec> void registerCodec() {
+    for (auto distribution : distributions) {
+        auto suffix = std::to_string(Bits) + "/" + Codec::name + "/" + name(distribution);
+        benchmark::RegisterBenchmark(("encode" + suffix).c_str(), encode<Bits, Codec>,
+                                     distribution);
+        benchmark::RegisterBenchmark(("decode" + suffix).c_str(), decode<Bits, Codec>,
+                                     distribution);
+    }
+}
+
+template <size_t Bits> void registerWidth() {
+    registerCodec<Bits, San<Bits>>();
+    registerCodec<Bits, SanString<Bits>>();
+    registerCodec<Bits, SanInline<Bits>>();
+    registerCodec<Bits, Hex>();
+    registerCodec<Bits, Decimal>();
+    registerCodec<Bits, Base64<Bits>>();
+}
+
+const bool registered = [] {
+    registerWidth<24>();
+    registerWidth<32>();
+    registerWidth<48>();
+    registerWidth<64>();
+    registerWidth<128>();
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,263 @@
+#include "bench.h"
+#include <algorithm>
+#include <random>
+#include <san.h>
+#include <sanSort.h>
+#include <swar.h>
+#include <tables.h>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Encodings of IDs with mixed magnitude, i.e., uniformly distributed lengths.
+ */
+std::vector<std::string> mixedEncodings(size_t count) {
+    std::mt19937_64 random(42);
+    std::vector<std::string> encodings(count);
+    for (auto &encoded : encodings) {
+        auto value = static_cast<int64_t>(random() >> random() % 64);
+        encoded = encode64Signed(random() & 1 ? ~value : value);
+    }
+    return encodings;
+}
+
+const std::vector<std::string> encodings = mixedEncodings(1 << 16); // NOLINT(cert-err58-cpp)
+
+/**
+ * The encodings as lines of a single buffer.
+ */
+std::string lines() {
+    std::string buffer;
+    for (const auto &encoded : encodings) {
+        buffer += encoded + '\n';
+    }
+    return buffer;
+}
+
+// the decoder as it was before decoding whole words, for comparison
+uint64_t tableLoop64(const std::string &input) {
+    auto res = input.front() == enc[ONES] ? -1ul : 0;
+    for (char byte : input) {
+        res = (res << 6) + dec[static_cast<int>(byte)];
+    }
+    return res;
+}
+
+// two characters per lookup, see SAN_TABLES=PAIR
+uint64_t pairLoop64(const std::string &input) {
+    auto res = input.front() == enc[ONES] ? -1ul : 0;
+    size_t pos = input.size() % 2;
+    if (pos) {
+        res = (res << 6) + dec[static_cast<int>(input[0])];
+    }
+    for (; pos < input.size(); pos += 2) {
+        res = (res << 12) + decPairs[input[pos] << 7 | input[pos + 1]];
+    }
+    return res;
+}
+
+// the word-at-a-time decoder, regardless of SAN_DECODER
+uint64_t swarLoop64(const std::string &input) {
+    auto res = input.front() == enc[ONES] ? -1ul : 0;
+    for (size_t pos = 0, n = (input.size() - 1) % 8 + 1; pos < input.size(); pos += n, n = 8) {
+        uint64_t blocks;
+        swar::decode(input.data() + pos, n, blocks);
+        res = res << 6 * n | blocks;
+    }
+    return res;
+}
+
+} // namespace
+
+static void decode64TableLoop(benchmark::State &state) {
+    Noise noise(state);
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tableLoop64(encodings[i++ & (encodings.size() - 1)]));
+        noise.touch();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(decode64TableLoop)->NOISE_ARGS;
+
+static void decode64PairTable(benchmark::State &state) {
+    Noise noise(state);
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pairLoop64(encodings[i++ & (encodings.size() - 1)]));
+        noise.touch();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(decode64PairTable)->NOISE_ARGS;
+
+static void decode64Swar(benchmark::State &state) {
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(swarLoop64(encodings[i++ & (encodings.size() - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(decode64Swar);
+
+static void decode64Unchecked(benchmark::State &state) {
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decode64(encodings[i++ & (encodings.size() - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(decode64Unchecked);
+
+static void decode64Checked(benchmark::State &state) {
+    size_t i = 0;
+    uint64_t value;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        const auto &encoded = encodings[i++ & (encodings.size() - 1)];
+        benchmark::DoNotOptimize(from_chars(encoded, value));
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(decode64Checked);
+
+static void decode64Lines(benchmark::State &state) {
+    auto buffer = lines();
+    std::vector<uint64_t> out(encodings.size());
+    PerfCounters perf(state, encodings.size());
+    for (auto _ : state) {
+        size_t count = 0;
+        for (size_t pos = 0; pos < buffer.size();) {
+            auto end = buffer.find('\n', pos);
+            from_chars(buffer.data() + pos, buffer.data() + end, out[count++]);
+            pos = end + 1;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * encodings.size());
+}
+BENCHMARK(decode64Lines);
+
+static void decode64Batch(benchmark::State &state) {
+    auto buffer = lines();
+    std::vector<uint64_t> out(encodings.size());
+    PerfCounters perf(state, encodings.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decodeBatch64(buffer.data(), buffer.size(), '\n', out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * encodings.size());
+}
+BENCHMARK(decode64Batch);
+
+static void valid64Lines(benchmark::State &state) {
+    auto buffer = lines();
+    PerfCounters perf(state, encodings.size());
+    for (auto _ : state) {
+        for (size_t pos = 0; pos < buffer.size();) {
+            auto end = buffer.find('\n', pos);
+            benchmark::DoNotOptimize(valid(buffer.substr(pos, end - pos), 64));
+            pos = end + 1;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(valid64Lines);
+
+static void valid64Batch(benchmark::State &state) {
+    auto buffer = lines();
+    PerfCounters perf(state, encodings.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validBatch(buffer.data(), buffer.size(), '\n', 64));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(valid64Batch);
+
+static void compare64Decoded(benchmark::State &state) {
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        const auto &a = encodings[i & (encodings.size() - 1)];
+        const auto &b = encodings[++i & (encodings.size() - 1)];
+        benchmark::DoNotOptimize(static_cast<int64_t>(decode64(a)) <
+                                 static_cast<int64_t>(decode64(b)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(compare64Decoded);
+
+static void compare64Encoded(benchmark::State &state) {
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        const auto &a = encodings[i & (encodings.size() - 1)];
+        const auto &b = encodings[++i & (encodings.size() - 1)];
+        benchmark::DoNotOptimize(compare64(a, b) < 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(compare64Encoded);
+
+static void canonicalize64Copy(benchmark::State &state) {
+    // the baseline: copying the buffer, which canonicalizeBatch() works on in place
+    auto buffer = lines();
+    auto work = buffer;
+    for (auto _ : state) {
+        memcpy(work.data(), buffer.data(), buffer.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(canonicalize64Copy);
+
+static void canonicalize64Batch(benchmark::State &state) {
+    // every 16th token with a redundant leading block
+    std::string buffer;
+    for (size_t i = 0; i < encodings.size(); ++i) {
+        auto padding = i % 16 ? "" : encodings[i][0] == '-' ? "-" : "+";
+        buffer += padding + encodings[i] + '\n';
+    }
+    auto work = buffer;
+    for (auto _ : state) {
+        memcpy(work.data(), buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(canonicalizeBatch(work.data(), work.size(), '\n'));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(canonicalize64Batch);
+
+static void sort64Std(benchmark::State &state) {
+    // the baseline: decoding into a side array of values and indices, and sorting it
+    std::vector<std::pair<int64_t, size_t>> pairs(encodings.size());
+    std::vector<size_t> order(encodings.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < encodings.size(); ++i) {
+            pairs[i] = {decode64Signed(encodings[i]), i};
+        }
+        std::sort(pairs.begin(), pairs.end());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            order[i] = pairs[i].second;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * encodings.size());
+}
+BENCHMARK(sort64Std);
+
+static void sort64Radix(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sortEncodedIndex<64, true>(encodings));
+    }
+    state.SetItemsProcessed(state.iterations() * encodings.size());
+}
+BENCHMARK(sort64Radix);
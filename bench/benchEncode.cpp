@@ -0,0 +1,258 @@
+#include "bench.h"
+#include <array>
+#include <cstring>
+#include <random>
+#include <san.h>
+#include <sanEncoded.h>
+#include <tables.h>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * IDs of mixed magnitude, i.e., uniformly distributed encoding lengths, which
+ * is the worst case for any length detection that depends on the data.
+ */
+std::vector<int64_t> mixedMagnitudes(size_t count) {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(count);
+    for (auto &value : values) {
+        value = static_cast<int64_t>(random() >> random() % 64);
+        if (random() & 1) {
+            value = ~value;
+        }
+    }
+    return values;
+}
+
+const std::vector<int64_t> values = mixedMagnitudes(1 << 16); // NOLINT(cert-err58-cpp)
+
+// the encoder as it was before counting the leading sign bits, for comparison
+#define CASE(i)                                                                                    \
+    if (blocks[(i) + 1] != enc[ONES] ? blocks[i] != enc[0] : blocks[i] != enc[ONES]) {             \
+        return blocks.data() + (i);                                                                \
+    }
+
+const char *caseChain64(std::array<char, 11> &blocks, int64_t input) {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i] = enc[input >> 6 * (blocks.size() - 1 - i) & ONES];
+    }
+    CASE(0)
+    CASE(1)
+    CASE(2)
+    CASE(3)
+    CASE(4)
+    CASE(5)
+    CASE(6)
+    CASE(7)
+    CASE(8)
+    CASE(9)
+    return blocks.data() + 10;
+}
+
+// all blocks of a 64-bit value, one or two at a time, to compare the table footprints
+void singles64(char *out, int64_t input) {
+    for (size_t i = 0; i < maxLength(64); ++i) {
+        out[i] = enc[input >> 6 * (maxLength(64) - 1 - i) & ONES];
+    }
+}
+
+void pairs64(char *out, int64_t input) {
+    out[0] = enc[input >> 60 & ONES];
+    for (size_t i = 1; i < maxLength(64); i += 2) {
+        memcpy(out + i, &encPairs[2 * static_cast<size_t>(input >> 6 * (9 - i) & 0xfff)], 2);
+    }
+}
+
+} // namespace
+
+static void encode64CaseChain(benchmark::State &state) {
+    std::array<char, 11> blocks{};
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(caseChain64(blocks, values[i++ & (values.size() - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode64CaseChain);
+
+static void encode64SignBits(benchmark::State &state) {
+    char buffer[maxLength(64)];
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto value = values[i++ & (values.size() - 1)];
+        auto res = encode64Signed(buffer, buffer + sizeof(buffer), value);
+        benchmark::DoNotOptimize(res.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode64SignBits);
+
+static void encode128SignBits(benchmark::State &state) {
+    char buffer[maxLength(128)];
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto value = values[i++ & (values.size() - 1)];
+        auto res = encode128Signed(buffer, buffer + sizeof(buffer), value >> 63, value);
+        benchmark::DoNotOptimize(res.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode128SignBits);
+
+static void encode128Native(benchmark::State &state) {
+    char buffer[maxLength(128)];
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto value = static_cast<__int128>(values[i++ & (values.size() - 1)]);
+        auto res = encode128Signed(buffer, buffer + sizeof(buffer), value);
+        benchmark::DoNotOptimize(res.ptr);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode128Native);
+
+static void encodeBytes256(benchmark::State &state) {
+    // SHA-256 digests, i.e., uniformly random bytes
+    std::vector<uint8_t> digests(32 * 1024);
+    std::mt19937 random(42);
+    for (auto &byte : digests) {
+        byte = static_cast<uint8_t>(random());
+    }
+    char buffer[maxLength(256)];
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        auto digest = digests.data() + 32 * (i++ & 1023);
+        benchmark::DoNotOptimize(encodeBytes(digest, 32, buffer));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(32 * state.iterations());
+}
+BENCHMARK(encodeBytes256);
+
+static void encode64SingleTable(benchmark::State &state) {
+    char buffer[maxLength(64)];
+    Noise noise(state);
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        singles64(buffer, values[i++ & (values.size() - 1)]);
+        benchmark::ClobberMemory();
+        noise.touch();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode64SingleTable)->NOISE_ARGS;
+
+static void encode64PairTable(benchmark::State &state) {
+    char buffer[maxLength(64)];
+    Noise noise(state);
+    size_t i = 0;
+    PerfCounters perf(state);
+    for (auto _ : state) {
+        pairs64(buffer, values[i++ & (values.size() - 1)]);
+        benchmark::ClobberMemory();
+        noise.touch();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(encode64PairTable)->NOISE_ARGS;
+
+static void encode64Loop(benchmark::State &state) {
+    std::vector<char> out(values.size() * maxLength(64));
+    std::vector<uint32_t> offsets(values.size() + 1);
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        auto pos = out.data();
+        for (size_t i = 0; i < values.size(); ++i) {
+            offsets[i] = static_cast<uint32_t>(pos - out.data());
+            pos = encode64Signed(pos, out.data() + out.size(), values[i]).ptr;
+        }
+        offsets[values.size()] = static_cast<uint32_t>(pos - out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode64Loop);
+
+// sequential IDs, each encoded on its own, and incremented from its predecessor
+static void encode64Sequential(benchmark::State &state) {
+    std::vector<Encoded<64>> out(values.size());
+    int64_t start = 1l << 40;
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = encodeInline<64, true>(start + static_cast<int64_t>(i));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode64Sequential);
+
+static void encode64Range(benchmark::State &state) {
+    std::vector<Encoded<64>> out(values.size());
+    int64_t start = 1l << 40;
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        encodeRange<64, true>(start, out.size(), out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode64Range);
+
+static void encode32Batch(benchmark::State &state) {
+    std::vector<int32_t> input(values.begin(), values.end());
+    std::vector<char> out(values.size() * maxLength(32));
+    std::vector<uint32_t> offsets(values.size() + 1);
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            encodeBatch32(input.data(), input.size(), out.data(), offsets.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode32Batch);
+
+static void encode64Batch(benchmark::State &state) {
+    std::vector<char> out(values.size() * maxLength(64));
+    std::vector<uint32_t> offsets(values.size() + 1);
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            encodeBatch64(values.data(), values.size(), out.data(), offsets.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode64Batch);
+
+static void encode128Batch(benchmark::State &state) {
+    std::vector<std::pair<int64_t, int64_t>> input;
+    for (auto value : values) {
+        input.emplace_back(value >> 63, value);
+    }
+    std::vector<char> out(values.size() * maxLength(128));
+    std::vector<uint32_t> offsets(values.size() + 1);
+    PerfCounters perf(state, values.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            encodeBatch128(input.data(), input.size(), out.data(), offsets.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(encode128Batch);
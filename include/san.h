@@ -1,11 +1,75 @@
 #ifndef LIBSAN_SAN_H
 #define LIBSAN_SAN_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// the 128 bit functions, and the kernels behind all of them, use the native 128 bit integers
+#ifndef __SIZEOF_INT128__
+#error "libSAN needs __int128, i.e., a compiler like GCC or Clang"
+#endif
 
 namespace san {
 
-enum class ERROR { OK, EMPTY, HIGH_BIT, WRONG_CHAR, TOO_LONG };
+enum class ERROR { OK, EMPTY, HIGH_BIT, WRONG_CHAR, TOO_LONG, NO_SPACE, TOO_SHORT };
+
+/**
+ * The order of the bytes of a byte array, which encodeBytes() takes as one big integer.
+ */
+enum class ENDIAN { BIG, LITTLE };
+
+/**
+ * The maximum length of an encoding for the given bit size, e.g., 4 characters
+ * for 24 bit, 6 for 32 bit, 8 for 48 bit, 11 for 64 bit and 22 for 128 bit.
+ *
+ * @param bitSize length of the encoded input
+ * @return the size of a buffer that can hold every encoding of that bit size
+ */
+constexpr size_t maxLength(size_t bitSize) { return (bitSize + 5) / 6; }
+
+/**
+ * Result of the buffer-based encoding functions, modelled after std::to_chars.
+ *
+ * On success, ptr points one past the last written character and ec is ERROR::OK.
+ * Like std::to_chars, no characters behind ptr are written.
+ * If the buffer is too small for the encoding, ptr equals the end of the buffer,
+ * ec is ERROR::NO_SPACE and the content of the buffer is unspecified.
+ */
+struct to_chars_result {
+    char *ptr;
+    ERROR ec;
+};
+
+/**
+ * Result of the checked decoding functions, modelled after std::from_chars.
+ *
+ * On success, ptr equals the end of the input and ec is ERROR::OK. Otherwise, ec
+ * is the same error valid() reports for the input and the width of the decoder,
+ * ptr points to the offending character (the start of the input for EMPTY and for
+ * an invalid first block) and the output value is left untouched.
+ */
+struct from_chars_result {
+    const char *ptr;
+    ERROR ec;
+};
+
+/**
+ * Result of the batch decoding functions, i.e., of decoding a buffer of tokens.
+ *
+ * On success, ptr equals the end of the buffer, ec is ERROR::OK and count is the number
+ * of decoded tokens. Otherwise, decoding stops at the first malformed token: ptr and ec
+ * are set like in from_chars_result (an empty token is ERROR::EMPTY), and count is the
+ * number of tokens before it, i.e., the index of the malformed one.
+ */
+struct decode_batch_result {
+    const char *ptr;
+    ERROR ec;
+    size_t count;
+};
 
 /**
  * Determines whether the string is a valid encoding, i.e., all characters
@@ -23,7 +87,50 @@ enum class ERROR { OK, EMPTY, HIGH_BIT, WRONG_CHAR, TOO_LONG };
 ERROR valid(const std::string &input, size_t bitSize = 0);
 
 /**
- * Encodes a 3-byte input value into an up-to 4-byte output string.
+ * Validates a buffer of delimiter-separated tokens, e.g., a capture file with one
+ * encoding per line, like valid() validates each token. An empty token is ERROR::EMPTY,
+ * but a single trailing delimiter is allowed. With SSSE3 (or AVX2, or AVX-512), it
+ * classifies 64 characters at a time and checks the tokens one by one only around errors.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param bitSize (optional) length of the originally encoded inputs
+ * @return the end of the buffer and the number of tokens, or the first error
+ */
+decode_batch_result validBatch(const char *buffer, size_t length, char delimiter,
+                               size_t bitSize = 0);
+
+/**
+ * Validates a buffer of delimiter-separated tokens like the other overload, but does not
+ * stop at the first malformed token.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param bitSize length of the originally encoded inputs, or 0 to skip the length checks
+ * @param errors receives the position and the error of every malformed token, in order
+ * @return the number of tokens, including the malformed ones
+ */
+size_t validBatch(const char *buffer, size_t length, char delimiter, size_t bitSize,
+                  std::vector<from_chars_result> &errors);
+
+/**
+ * Strips the redundant leading blocks of all delimiter-separated tokens of a buffer in
+ * place, so equal values have equal encodings, e.g., for hashing or joins on encoded
+ * columns, see canonicalize() in sanCodec.h. The tokens are not validated. With SSSE3
+ * (or AVX2, or AVX-512), it looks at 64 characters at a time and moves the characters
+ * behind the first redundant block only.
+ *
+ * @param buffer start of the tokens, receives the canonical ones
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @return the new length of the buffer, which is unchanged behind it
+ */
+size_t canonicalizeBatch(char *buffer, size_t length, char delimiter);
+
+/**
+ * Encodes a 3-byte input value into an up-to 4-byte output buffer.
  * The first byte is irrelevant and will be ignored.
  * Signedness will just work, within the bound of a signed 24 bit value.
  *
@@ -32,10 +139,37 @@ ERROR valid(const std::string &input, size_t bitSize = 0);
  * to explicitly mark some positive numbers with a leading 1s block with an
  * additional 0s block.
  *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(24) characters are always enough
+ * @param input a 24 bit value, encoded within a 32 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode24Signed(char *first, char *last, int32_t input);
+
+/**
+ * Encodes a 3-byte input value into an up-to 4-byte output string.
+ * See the buffer-based overload for details on the encoding.
+ *
  * @param input a 24 bit value, encoded within a 32 bit value
  * @return a non-empty encoding of the input value.
  */
-std::string encode24Signed(int32_t input);
+inline std::string encode24Signed(int32_t input) {
+    char buffer[maxLength(24)];
+    return {buffer, encode24Signed(buffer, buffer + sizeof(buffer), input).ptr};
+}
+
+/**
+ * Convenience method for unsigned values; the encoding does not change and
+ * will still encode very high unsigned values sparse.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(24) characters are always enough
+ * @param input a 24 bit value, embedded within an unsigned 32 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result encode24(char *first, char *last, uint32_t input) {
+    return encode24Signed(first, last, static_cast<int32_t>(input));
+}
 
 /**
  * Convenience method for unsigned values; the encoding does not change and
@@ -46,7 +180,7 @@ std::string encode24Signed(int32_t input);
 inline std::string encode24(uint32_t input) { return encode24Signed(static_cast<int32_t>(input)); }
 
 /**
- * Encodes a 4-byte input value into an up-to 6-byte output string.
+ * Encodes a 4-byte input value into an up-to 6-byte output buffer.
  *
  * The output will be as short as possible, by omitting leading 0 blocks.
  * Also we omit repeated, leading blocks of 1s, with the downside of having
@@ -57,10 +191,37 @@ inline std::string encode24(uint32_t input) { return encode24Signed(static_cast<
  * be encoded with the 000000, 000001, 111110 and 111111 block (since we honor
  * the sign!). For our encoding this means '+', '1', '0' or '-', respectively.
  *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(32) characters are always enough
+ * @param input a 32 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode32Signed(char *first, char *last, int32_t input);
+
+/**
+ * Encodes a 4-byte input value into an up-to 6-byte output string.
+ * See the buffer-based overload for details on the encoding.
+ *
  * @param input a 32 bit value
  * @return a non-empty encoding of the input value.
  */
-std::string encode32Signed(int32_t input);
+inline std::string encode32Signed(int32_t input) {
+    char buffer[maxLength(32)];
+    return {buffer, encode32Signed(buffer, buffer + sizeof(buffer), input).ptr};
+}
+
+/**
+ * Convenience method for unsigned values; the encoding does not change and
+ * will still encode very high unsigned values sparse.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(32) characters are always enough
+ * @param input a 32 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result encode32(char *first, char *last, uint32_t input) {
+    return encode32Signed(first, last, static_cast<int32_t>(input));
+}
 
 /**
  * Convenience method for unsigned values; the encoding does not change and
@@ -71,7 +232,7 @@ std::string encode32Signed(int32_t input);
 inline std::string encode32(uint32_t input) { return encode32Signed(static_cast<int32_t>(input)); }
 
 /**
- * Encodes a 6-byte input value into an up-to 8-byte output string.
+ * Encodes a 6-byte input value into an up-to 8-byte output buffer.
  * The first two bytes are irrelevant and will be ignored.
  * Signedness will just work, within the bound of a signed 48 bit value.
  *
@@ -80,10 +241,37 @@ inline std::string encode32(uint32_t input) { return encode32Signed(static_cast<
  * to explicitly mark some positive numbers with a leading 1s block with an
  * additional 0s block.
  *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(48) characters are always enough
+ * @param input a 48 bit value, encoded within a 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode48Signed(char *first, char *last, int64_t input);
+
+/**
+ * Encodes a 6-byte input value into an up-to 8-byte output string.
+ * See the buffer-based overload for details on the encoding.
+ *
  * @param input a 24 bit value, encoded within a 64 bit value
  * @return a non-empty encoding of the input value.
  */
-std::string encode48Signed(int64_t input);
+inline std::string encode48Signed(int64_t input) {
+    char buffer[maxLength(48)];
+    return {buffer, encode48Signed(buffer, buffer + sizeof(buffer), input).ptr};
+}
+
+/**
+ * Convenience method for unsigned values; the encoding does not change and
+ * will still encode very high unsigned values sparse.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(48) characters are always enough
+ * @param input a 48 bit value, embedded within an unsigned 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result encode48(char *first, char *last, uint64_t input) {
+    return encode48Signed(first, last, static_cast<int64_t>(input));
+}
 
 /**
  * Convenience method for unsigned values; the encoding does not change and
@@ -95,7 +283,7 @@ std::string encode48Signed(int64_t input);
 inline std::string encode48(uint64_t input) { return encode48Signed(static_cast<int64_t>(input)); }
 
 /**
- * Encodes a 8-byte input value into an up-to 11-byte output string.
+ * Encodes a 8-byte input value into an up-to 11-byte output buffer.
  *
  * The output will be as short as possible, by omitting leading 0 blocks.
  * Also we omit repeated, leading blocks of 1s, with the downside of having
@@ -105,10 +293,37 @@ inline std::string encode48(uint64_t input) { return encode48Signed(static_cast<
  * For 64-bit values, we are left with a 4-bit high block, that will only ever
  * be encoded with the 16 different blocks (since we honor the sign!).
  *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(64) characters are always enough
+ * @param input a 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode64Signed(char *first, char *last, int64_t input);
+
+/**
+ * Encodes a 8-byte input value into an up-to 11-byte output string.
+ * See the buffer-based overload for details on the encoding.
+ *
  * @param input a 64 bit value
  * @return a non-empty encoding of the input value.
  */
-std::string encode64Signed(int64_t input);
+inline std::string encode64Signed(int64_t input) {
+    char buffer[maxLength(64)];
+    return {buffer, encode64Signed(buffer, buffer + sizeof(buffer), input).ptr};
+}
+
+/**
+ * Convenience method for unsigned values; the encoding does not change and
+ * will still encode very high unsigned values sparse.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(64) characters are always enough
+ * @param input a 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result encode64(char *first, char *last, uint64_t input) {
+    return encode64Signed(first, last, static_cast<int64_t>(input));
+}
 
 /**
  * Convenience method for unsigned values; the encoding does not change and
@@ -120,18 +335,47 @@ std::string encode64Signed(int64_t input);
 inline std::string encode64(uint64_t input) { return encode64Signed(static_cast<int64_t>(input)); }
 
 /**
- * Encodes a 16-byte input value into an up-to 22-byte output string.
+ * Encodes a 16-byte input value into an up-to 22-byte output buffer.
  *
  * The output will be as short as possible, by omitting leading 0 blocks.
  * Also we omit repeated, leading blocks of 1s, with the downside of having
  * to explicitly mark some positive numbers with a leading 1s block with an
  * additional 0s block.
  *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(128) characters are always enough
+ * @param ab the first 64 bit value
+ * @param cd the second 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode128Signed(char *first, char *last, int64_t ab, int64_t cd);
+
+/**
+ * Encodes a 16-byte input value into an up-to 22-byte output string.
+ * See the buffer-based overload for details on the encoding.
+ *
  * @param ab the first 64 bit value
  * @param cd the first 64 bit value
  * @return a non-empty encoding of the input value.
  */
-std::string encode128Signed(int64_t ab, int64_t cd);
+inline std::string encode128Signed(int64_t ab, int64_t cd) {
+    char buffer[maxLength(128)];
+    return {buffer, encode128Signed(buffer, buffer + sizeof(buffer), ab, cd).ptr};
+}
+
+/**
+ * Convenience method for unsigned values; the encoding does not change and
+ * will still encode very high unsigned values sparse.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(128) characters are always enough
+ * @param ab the first 64 bit value
+ * @param cd the second 64 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result encode128(char *first, char *last, uint64_t ab, uint64_t cd) {
+    return encode128Signed(first, last, static_cast<int64_t>(ab), static_cast<int64_t>(cd));
+}
 
 /**
  * Convenience method for unsigned values; the encoding does not change and
@@ -144,13 +388,143 @@ inline std::string encode128(uint64_t ab, uint64_t cd) {
     return encode128Signed(static_cast<int64_t>(ab), static_cast<int64_t>(cd));
 }
 
+/**
+ * Encodes a native 128 bit value like encode128Signed(first, last, ab, cd) encodes its
+ * halves, but without splitting and joining them.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer, maxLength(128) characters are always enough
+ * @param input a 128 bit value
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+to_chars_result encode128Signed(char *first, char *last, __int128 input);
+
+inline std::string encode128Signed(__int128 input) {
+    char buffer[maxLength(128)];
+    return {buffer, encode128Signed(buffer, buffer + sizeof(buffer), input).ptr};
+}
+
+inline to_chars_result encode128(char *first, char *last, unsigned __int128 input) {
+    return encode128Signed(first, last, static_cast<__int128>(input));
+}
+
+inline std::string encode128(unsigned __int128 input) {
+    return encode128Signed(static_cast<__int128>(input));
+}
+
+/**
+ * Generic, non-allocating encoding, modelled after std::to_chars. The width of
+ * the encoding is derived from the type of the value, i.e., 32 bit for (u)int32_t,
+ * 64 bit for (u)int64_t and 128 bit for a pair of (u)int64_t or (unsigned) __int128. For
+ * the 24 and 48 bit encodings, use the buffer-based overloads of encode24Signed and
+ * encode48Signed.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer
+ * @param input the value to encode
+ * @return the end of the non-empty encoding, or ERROR::NO_SPACE
+ */
+inline to_chars_result to_chars(char *first, char *last, int32_t input) {
+    return encode32Signed(first, last, input);
+}
+
+inline to_chars_result to_chars(char *first, char *last, uint32_t input) {
+    return encode32(first, last, input);
+}
+
+inline to_chars_result to_chars(char *first, char *last, int64_t input) {
+    return encode64Signed(first, last, input);
+}
+
+inline to_chars_result to_chars(char *first, char *last, uint64_t input) {
+    return encode64(first, last, input);
+}
+
+inline to_chars_result to_chars(char *first, char *last, std::pair<int64_t, int64_t> input) {
+    return encode128Signed(first, last, input.first, input.second);
+}
+
+inline to_chars_result to_chars(char *first, char *last, std::pair<uint64_t, uint64_t> input) {
+    return encode128(first, last, input.first, input.second);
+}
+
+inline to_chars_result to_chars(char *first, char *last, __int128 input) {
+    return encode128Signed(first, last, input);
+}
+
+inline to_chars_result to_chars(char *first, char *last, unsigned __int128 input) {
+    return encode128(first, last, input);
+}
+
+/**
+ * Encodes an array of 4-byte values, which is considerably faster than encoding them
+ * one by one (especially with AVX2), producing the same characters as encode32Signed.
+ * The encodings are concatenated, i.e., the i-th one is [out + offsets[i], out + offsets[i + 1]).
+ *
+ * @param in the values to encode
+ * @param n number of values
+ * @param out the output buffer, of at least n * maxLength(32) characters
+ * @param offsets receives the n + 1 offsets of the encodings, starting at 0
+ * @return the end of the written encodings, the characters behind it may be overwritten
+ */
+char *encodeBatch32(const int32_t *in, size_t n, char *out, uint32_t *offsets);
+
+inline char *encodeBatch32(const uint32_t *in, size_t n, char *out, uint32_t *offsets) {
+    return encodeBatch32(reinterpret_cast<const int32_t *>(in), n, out, offsets);
+}
+
+/**
+ * Encodes an array of 6-byte values (using 64-bit data types), see encodeBatch32 and
+ * encode48Signed.
+ *
+ * @param in the values to encode
+ * @param n number of values
+ * @param out the output buffer, of at least n * maxLength(48) characters
+ * @param offsets receives the n + 1 offsets of the encodings, starting at 0
+ * @return the end of the written encodings, the characters behind it may be overwritten
+ */
+char *encodeBatch48(const int64_t *in, size_t n, char *out, uint32_t *offsets);
+
+inline char *encodeBatch48(const uint64_t *in, size_t n, char *out, uint32_t *offsets) {
+    return encodeBatch48(reinterpret_cast<const int64_t *>(in), n, out, offsets);
+}
+
+/**
+ * Encodes an array of 8-byte values, see encodeBatch32 and encode64Signed.
+ *
+ * @param in the values to encode
+ * @param n number of values
+ * @param out the output buffer, of at least n * maxLength(64) characters
+ * @param offsets receives the n + 1 offsets of the encodings, starting at 0
+ * @return the end of the written encodings, the characters behind it may be overwritten
+ */
+char *encodeBatch64(const int64_t *in, size_t n, char *out, uint32_t *offsets);
+
+inline char *encodeBatch64(const uint64_t *in, size_t n, char *out, uint32_t *offsets) {
+    return encodeBatch64(reinterpret_cast<const int64_t *>(in), n, out, offsets);
+}
+
+/**
+ * Encodes an array of 16-byte values, given as pairs of their most and least significant
+ * 8 bytes, see encodeBatch32 and encode128Signed.
+ *
+ * @param in the values to encode
+ * @param n number of values
+ * @param out the output buffer, of at least n * maxLength(128) characters
+ * @param offsets receives the n + 1 offsets of the encodings, starting at 0
+ * @return the end of the written encodings, the characters behind it may be overwritten
+ */
+char *encodeBatch128(const std::pair<int64_t, int64_t> *in, size_t n, char *out,
+                     uint32_t *offsets);
+
 /**
  * Decodes a previously encoded 3-byte value from its string representation.
+ * The input is not validated, use the checked overload for untrusted input.
  *
  * @param input a 1-4 byte string, which was the output of a previous encoding call
  * @return the decoded 24 bit value, interpreted as unsigned value
  */
-uint32_t decode24(const std::string &input);
+uint32_t decode24(std::string_view input);
 
 /**
  * Convenience method for signed values; the decoding does not differ from
@@ -160,18 +534,48 @@ uint32_t decode24(const std::string &input);
  * @param input a 1-4 byte string, which was the output of a previous encoding call
  * @return the decoded 24 bit value, with the highest 8 bit replicating the sign
  */
-inline int32_t decode24Signed(const std::string &input) {
+inline int32_t decode24Signed(std::string_view input) {
     auto res = static_cast<int32_t>(decode24(input));
     return res & 0x00800000 ? res | static_cast<int32_t>(0xff000000) : res;
 }
 
+/**
+ * Decodes a 3-byte value from the range [first, last), while validating it in the
+ * same pass, i.e., it reports the same errors as valid(input, 24).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 24 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode24(const char *first, const char *last, uint32_t &output);
+
+/**
+ * Checked convenience method for signed values, see decode24Signed(input).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 24 bit value, with the highest 8 bit replicating the sign
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result decode24Signed(const char *first, const char *last, int32_t &output) {
+    uint32_t res;
+    auto result = decode24(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = res & 0x00800000 ? static_cast<int32_t>(res | 0xff000000)
+                                  : static_cast<int32_t>(res);
+    }
+    return result;
+}
+
 /**
  * Decodes a previously encoded 4-byte value from its string representation.
+ * The input is not validated, use the checked overload for untrusted input.
  *
  * @param input a 1-6 byte string, which was the output of a previous encoding call
  * @return the decoded 32 bit value, interpreted as unsigned value
  */
-uint32_t decode32(const std::string &input);
+uint32_t decode32(std::string_view input);
 
 /**
  * Convenience method for signed values; the decoding does not differ from the unsigned one.
@@ -179,17 +583,46 @@ uint32_t decode32(const std::string &input);
  * @param input a 1-6 byte string, which was the output of a previous encoding call
  * @return the decoded 32 bit value
  */
-inline int32_t decode32Signed(const std::string &input) {
+inline int32_t decode32Signed(std::string_view input) {
     return static_cast<int32_t>(decode32(input));
 }
 
+/**
+ * Decodes a 4-byte value from the range [first, last), while validating it in the
+ * same pass, i.e., it reports the same errors as valid(input, 32).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 32 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode32(const char *first, const char *last, uint32_t &output);
+
+/**
+ * Checked convenience method for signed values, see decode32Signed(input).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 32 bit value
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result decode32Signed(const char *first, const char *last, int32_t &output) {
+    uint32_t res;
+    auto result = decode32(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<int32_t>(res);
+    }
+    return result;
+}
+
 /**
  * Decodes a previously encoded 6-byte value from its string representation.
+ * The input is not validated, use the checked overload for untrusted input.
  *
  * @param input a 1-8 byte string, which was the output of a previous encoding call
  * @return the decoded 48 bit value, interpreted as unsigned value
  */
-uint64_t decode48(const std::string &input);
+uint64_t decode48(std::string_view input);
 
 /**
  * Convenience method for signed values; the decoding does not differ from the unsigned one,
@@ -198,18 +631,48 @@ uint64_t decode48(const std::string &input);
  * @param input a 1-8 byte string, which was the output of a previous encoding call
  * @return the decoded 48 bit value, with the highest 16 bit replicating the sign
  */
-inline int64_t decode48Signed(const std::string &input) {
+inline int64_t decode48Signed(std::string_view input) {
     auto res = static_cast<int64_t>(decode48(input));
     return res & 0x00800000000000 ? res | static_cast<int64_t>(0xffff000000000000) : res;
 }
 
+/**
+ * Decodes a 6-byte value from the range [first, last), while validating it in the
+ * same pass, i.e., it reports the same errors as valid(input, 48).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 48 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode48(const char *first, const char *last, uint64_t &output);
+
+/**
+ * Checked convenience method for signed values, see decode48Signed(input).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 48 bit value, with the highest 16 bit replicating the sign
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result decode48Signed(const char *first, const char *last, int64_t &output) {
+    uint64_t res;
+    auto result = decode48(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = res & 0x00800000000000 ? static_cast<int64_t>(res | 0xffff000000000000)
+                                        : static_cast<int64_t>(res);
+    }
+    return result;
+}
+
 /**
  * Decodes a previously encoded 8-byte value from its string representation.
+ * The input is not validated, use the checked overload for untrusted input.
  *
  * @param input a 1-11 byte string, which was the output of a previous encoding call
  * @return the decoded 64 bit value, interpreted as unsigned value
  */
-uint64_t decode64(const std::string &input);
+uint64_t decode64(std::string_view input);
 
 /**
  * Convenience method for signed values; the decoding does not differ from the unsigned one.
@@ -217,17 +680,46 @@ uint64_t decode64(const std::string &input);
  * @param input a 1-11 byte string, which was the output of a previous encoding call
  * @return the decoded 64 bit value
  */
-inline int64_t decode64Signed(const std::string &input) {
+inline int64_t decode64Signed(std::string_view input) {
     return static_cast<int64_t>(decode64(input));
 }
 
+/**
+ * Decodes an 8-byte value from the range [first, last), while validating it in the
+ * same pass, i.e., it reports the same errors as valid(input, 64).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 64 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode64(const char *first, const char *last, uint64_t &output);
+
+/**
+ * Checked convenience method for signed values, see decode64Signed(input).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 64 bit value
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result decode64Signed(const char *first, const char *last, int64_t &output) {
+    uint64_t res;
+    auto result = decode64(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<int64_t>(res);
+    }
+    return result;
+}
+
 /**
  * Decodes a previously encoded 16-byte value from its string representation.
+ * The input is not validated, use the checked overload for untrusted input.
  *
  * @param input a 1-22 byte string, which was the output of a previous encoding call
  * @return the decoded 128 bit value, interpreted as unsigned value
  */
-std::pair<uint64_t, uint64_t> decode128(const std::string &input);
+std::pair<uint64_t, uint64_t> decode128(std::string_view input);
 
 /**
  * Convenience method for signed values; the decoding does not differ from the unsigned one.
@@ -235,10 +727,343 @@ std::pair<uint64_t, uint64_t> decode128(const std::string &input);
  * @param input a 1-22 byte string, which was the output of a previous encoding call
  * @return the decoded 128 bit value
  */
-inline std::pair<int64_t, int64_t> decode128Signed(const std::string &input) {
+inline std::pair<int64_t, int64_t> decode128Signed(std::string_view input) {
     return static_cast<std::pair<int64_t, int64_t>>(decode128(input));
 }
 
+/**
+ * Decodes a 16-byte value from the range [first, last), while validating it in the
+ * same pass, i.e., it reports the same errors as valid(input, 128).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 128 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode128(const char *first, const char *last,
+                            std::pair<uint64_t, uint64_t> &output);
+
+/**
+ * Checked convenience method for signed values, see decode128Signed(input).
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 128 bit value
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result decode128Signed(const char *first, const char *last,
+                                         std::pair<int64_t, int64_t> &output) {
+    std::pair<uint64_t, uint64_t> res;
+    auto result = decode128(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<std::pair<int64_t, int64_t>>(res);
+    }
+    return result;
+}
+
+/**
+ * Decodes a previously encoded 16-byte value into a native 128 bit value, without
+ * joining its halves. The input is not validated, use the checked overload for untrusted
+ * input.
+ *
+ * @param input a 1-22 byte string, which was the output of a previous encoding call
+ * @return the decoded 128 bit value, interpreted as unsigned value
+ */
+unsigned __int128 decode128Native(std::string_view input);
+
+inline __int128 decode128NativeSigned(std::string_view input) {
+    return static_cast<__int128>(decode128Native(input));
+}
+
+/**
+ * Decodes and validates a 16-byte value like decode128(first, last, output) does, into a
+ * native 128 bit value.
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded 128 bit value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decode128(const char *first, const char *last, unsigned __int128 &output);
+
+inline from_chars_result decode128Signed(const char *first, const char *last,
+                                         __int128 &output) {
+    unsigned __int128 res;
+    auto result = decode128(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<__int128>(res);
+    }
+    return result;
+}
+
+/**
+ * Generic, checked decoding, modelled after std::from_chars. The width of the
+ * encoding is derived from the type of the output, i.e., 32 bit for (u)int32_t,
+ * 64 bit for (u)int64_t and 128 bit for a pair of (u)int64_t or (unsigned) __int128. For
+ * the 24 and 48 bit encodings, use the checked overloads of decode24 and decode48.
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param output the decoded value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+inline from_chars_result from_chars(const char *first, const char *last, int32_t &output) {
+    return decode32Signed(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last, uint32_t &output) {
+    return decode32(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last, int64_t &output) {
+    return decode64Signed(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last, uint64_t &output) {
+    return decode64(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last,
+                                    std::pair<int64_t, int64_t> &output) {
+    return decode128Signed(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last,
+                                    std::pair<uint64_t, uint64_t> &output) {
+    return decode128(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last, __int128 &output) {
+    return decode128Signed(first, last, output);
+}
+
+inline from_chars_result from_chars(const char *first, const char *last,
+                                    unsigned __int128 &output) {
+    return decode128(first, last, output);
+}
+
+/**
+ * Generic, checked decoding of a string view, see the pointer-based overloads.
+ *
+ * @param input the encoded input
+ * @param output the decoded value, only written on success
+ * @return the end of the input, or the error and its position
+ */
+template <typename T> from_chars_result from_chars(std::string_view input, T &output) {
+    return from_chars(input.data(), input.data() + input.size(), output);
+}
+
+/**
+ * Decodes a buffer of delimiter-separated 4-byte tokens, e.g., a line of comma-separated
+ * values or a list of lines, validating each token like the checked decode32. This avoids
+ * a string per token, and (with BMI2 and SSSE3) finds delimiters and decodes the tokens
+ * several at a time in vector registers. A single trailing delimiter is allowed.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param out receives the decoded values, at most (length + 1) / 2
+ * @return the end of the buffer and the number of tokens, or the first error
+ */
+decode_batch_result decodeBatch32(const char *buffer, size_t length, char delimiter,
+                                  uint32_t *out);
+
+/**
+ * Decodes a buffer of delimiter-separated 6-byte tokens, see decodeBatch32.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param out receives the decoded values, at most (length + 1) / 2
+ * @return the end of the buffer and the number of tokens, or the first error
+ */
+decode_batch_result decodeBatch48(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out);
+
+/**
+ * Decodes a buffer of delimiter-separated 8-byte tokens, see decodeBatch32.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param out receives the decoded values, at most (length + 1) / 2
+ * @return the end of the buffer and the number of tokens, or the first error
+ */
+decode_batch_result decodeBatch64(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out);
+
+/**
+ * Decodes a buffer of delimiter-separated 16-byte tokens, see decodeBatch32.
+ *
+ * @param buffer start of the tokens
+ * @param length number of characters
+ * @param delimiter the character between tokens, which must not be part of the alphabet
+ * @param out receives the decoded values, at most (length + 1) / 2
+ * @return the end of the buffer and the number of tokens, or the first error
+ */
+decode_batch_result decodeBatch128(const char *buffer, size_t length, char delimiter,
+                                   std::pair<uint64_t, uint64_t> *out);
+
+/**
+ * The exact length of the encoding of a byte array, see encodeBytes(), e.g., to size
+ * the output buffer. It is at most maxLength(8 * n).
+ *
+ * @param in the bytes of a signed integer, e.g., a SHA-256 digest or a 160-bit identifier
+ * @param n number of bytes, at least 1
+ * @param order whether the most significant byte is the first or the last one
+ * @return the number of characters encodeBytes() writes
+ */
+size_t encodeBytesLength(const uint8_t *in, size_t n, ENDIAN order = ENDIAN::BIG);
+
+/**
+ * Encodes a byte array of any size as one (8 * n)-bit integer, omitting leading 0s and
+ * 1s blocks like encode128Signed does, i.e., 16 bytes encode like their 128 bit value and
+ * 8 bytes like their 64 bit value. The bytes are converted 48 bits at a time, in the
+ * vectors of the kernel, if it has them.
+ *
+ * @param in the bytes of a signed integer, e.g., a SHA-256 digest or a 160-bit identifier
+ * @param n number of bytes, at least 1
+ * @param out the output buffer, of at least encodeBytesLength(in, n, order) characters
+ * @param order whether the most significant byte is the first or the last one
+ * @return the end of the non-empty encoding, nothing behind it is written
+ */
+char *encodeBytes(const uint8_t *in, size_t n, char *out, ENDIAN order = ENDIAN::BIG);
+
+/**
+ * Encodes a byte array into a string, see the buffer-based overload.
+ *
+ * @param in the bytes of a signed integer
+ * @param n number of bytes, at least 1
+ * @param order whether the most significant byte is the first or the last one
+ * @return a non-empty encoding of the bytes
+ */
+inline std::string encodeBytes(const uint8_t *in, size_t n, ENDIAN order = ENDIAN::BIG) {
+    std::string res(encodeBytesLength(in, n, order), '\0');
+    encodeBytes(in, n, res.data(), order);
+    return res;
+}
+
+/**
+ * Decodes the encoding of a byte array, while validating it like valid(input, 8 * n),
+ * and sign-extends it to n bytes.
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param out receives the n bytes, only written on success
+ * @param n number of bytes, at least 1
+ * @param order whether the most significant byte is the first or the last one
+ * @return the end of the input, or the error and its position
+ */
+from_chars_result decodeBytes(const char *first, const char *last, uint8_t *out, size_t n,
+                              ENDIAN order = ENDIAN::BIG);
+
+/**
+ * Compares two valid encodings of 32 bit values by the values as signed integers, without
+ * decoding them, i.e., like static_cast<int32_t>(decode32(a)) and decode32(b). Unlike the
+ * strings, equal values compare equal, even if one encoding has leading blocks the other
+ * omits, e.g., "++a" and "a". The result is unspecified for invalid encodings.
+ *
+ * @param a a valid encoding, see valid(a, 32)
+ * @param b another valid encoding
+ * @return a negative number if a is smaller, 0 if both are equal, otherwise a positive one
+ */
+int compare32(std::string_view a, std::string_view b);
+
+/**
+ * Compares encodings of 24 bit values, see compare32().
+ */
+int compare24(std::string_view a, std::string_view b);
+
+/**
+ * Compares encodings of 48 bit values, see compare32().
+ */
+int compare48(std::string_view a, std::string_view b);
+
+/**
+ * Compares encodings of 64 bit values, see compare32().
+ */
+int compare64(std::string_view a, std::string_view b);
+
+/**
+ * Compares encodings of 128 bit values, see compare32(). With SSSE3, the blocks are
+ * compared 16 at a time.
+ */
+int compare128(std::string_view a, std::string_view b);
+
+/**
+ * Name of the kernel, which all functions above dispatch to. On x86-64, the library is
+ * built for several instruction sets and picks the best one the CPU supports on first
+ * use: "scalar", "sse42" (SSE4.2), "avx2" (AVX2 with BMI2) or "avx512" (AVX-512 with
+ * VBMI). Other builds have a single kernel, "native" with SAN_NATIVE or "scalar".
+ *
+ * @return the name of the active kernel
+ */
+const char *activeKernel();
+
+/**
+ * Switches all functions to the named kernel, e.g., to compare kernels in a benchmark.
+ *
+ * @param name the name of a kernel, see activeKernel()
+ * @return whether the library has the kernel and the CPU supports it, otherwise the
+ *         active kernel stays
+ */
+bool useKernel(const char *name);
+
+/**
+ * Usage counters of the functions above, see collectStats(). They are only counted if the
+ * library is built with SAN_STATS (-DSAN_STATS=ON, which also defines SAN_STATS for its
+ * users), otherwise there is no overhead and all of them stay 0.
+ */
+struct stats {
+    struct width {
+        // calls of the encoders, plus the values of the batch encoders
+        uint64_t encodes;
+        // calls of the decoders, plus the tokens of the batch decoders
+        uint64_t decodes;
+        // calls of the comparisons, i.e., compare24() to compare128()
+        uint64_t compares;
+        // encodings by their length
+        uint64_t lengths[maxLength(128) + 1];
+        // encodings with a leading '+' only to tell them from leading 1s, e.g., "+-" for 63
+        uint64_t extraPlus;
+        // encodings with a leading '-' only for the leading 1s, e.g., "-Z" for -2
+        uint64_t extraMinus;
+    };
+
+    // by bit size: 24, 32, 48, 64 and 128
+    width widths[5];
+    // calls of valid(), plus the tokens of validBatch()
+    uint64_t validations;
+    // calls of canonicalizeBatch()
+    uint64_t canonicalizations;
+    // calls of encodeBytes() and decodeBytes()
+    uint64_t byteEncodes;
+    uint64_t byteDecodes;
+    // errors of all functions by ERROR, i.e., NO_SPACE of the encoders and the errors of
+    // valid(), validBatch() and the checked decoders (including the batch decoders and
+    // decodeBytes())
+    uint64_t errors[7];
+
+    /**
+     * Adds the counters of another snapshot, e.g., of another process.
+     */
+    stats &operator+=(const stats &other);
+};
+
+/**
+ * Takes a snapshot of the usage counters. Each thread counts on its own, without locks or
+ * contended atomics, and this sums the counters of all threads, including the finished
+ * ones, since the last resetStats().
+ *
+ * @return the sum of the counters of all threads
+ */
+stats collectStats();
+
+/**
+ * Starts the usage counters over, i.e., later snapshots only count the calls after it.
+ */
+void resetStats();
+
 } // namespace san
 
 #endif // LIBSAN_SAN_H
@@ -0,0 +1,812 @@
+#ifndef LIBSAN_SAN_CODEC_H
+#define LIBSAN_SAN_CODEC_H
+
+#include <array>
+#include <san.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace san {
+
+/**
+ * The alphabet of the functions in san.h: '+' encodes a block of 0s, '-' a block of 1s,
+ * and the digits and letters the blocks between, so most blocks look like hexadecimal.
+ *
+ * An alphabet is a type with a static string of 64 distinct, printable 7-bit characters
+ * (see isAlphabet()), the character of block i at index i. The first one encodes 0s and
+ * the last one 1s blocks, so these are the characters that leading blocks are omitted of.
+ */
+struct default_alphabet {
+    static constexpr char chars[65] =
+        "+123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0-";
+};
+
+/**
+ * Determines whether the string is an alphabet, i.e., consists of 64 distinct, printable
+ * 7-bit characters.
+ */
+constexpr bool isAlphabet(const char (&chars)[65]) {
+    for (size_t i = 0; i < 64; ++i) {
+        if (chars[i] <= ' ' || chars[i] >= 127) {
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (chars[i] == chars[j]) {
+                return false;
+            }
+        }
+    }
+    return chars[64] == '\0';
+}
+
+/**
+ * Generates the decode table of an alphabet, i.e., the block of every 7-bit character,
+ * or 64 if it is not part of the alphabet.
+ */
+constexpr std::array<uint8_t, 128> makeDecodeTable(const char (&chars)[65]) {
+    std::array<uint8_t, 128> table{};
+    for (auto &block : table) {
+        block = 64;
+    }
+    for (uint8_t i = 0; i < 64; ++i) {
+        table[static_cast<uint8_t>(chars[i])] = i;
+    }
+    return table;
+}
+
+/**
+ * The smallest integer type of at least the given bit size, e.g., uint16_t for 16 bits
+ * or int64_t for 40 signed bits, and (unsigned) __int128 for more than 64 bits.
+ */
+template <size_t Bits, bool Signed = false>
+using value_t = std::conditional_t<
+    (Bits <= 8), std::conditional_t<Signed, int8_t, uint8_t>,
+    std::conditional_t<
+        (Bits <= 16), std::conditional_t<Signed, int16_t, uint16_t>,
+        std::conditional_t<
+            (Bits <= 32), std::conditional_t<Signed, int32_t, uint32_t>,
+            std::conditional_t<(Bits <= 64), std::conditional_t<Signed, int64_t, uint64_t>,
+                               std::conditional_t<Signed, __int128, unsigned __int128>>>>>;
+
+/**
+ * The rules of the encoding, which the kernels of the library (see kernel.cpp) and
+ * basic_codec share, independent of the alphabet.
+ */
+namespace rules {
+
+/**
+ * Number of significant bits, i.e., the position of the most significant 1 bit,
+ * but at least 1 (so zero does not need special treatment).
+ */
+constexpr size_t significantBits(uint64_t value) { return 64 - __builtin_clzll(value | 1); }
+
+constexpr size_t significantBits(unsigned __int128 value) {
+    auto high = static_cast<uint64_t>(value >> 64);
+    auto low = static_cast<uint64_t>(value);
+    return high ? 128 - __builtin_clzll(high) : significantBits(low);
+}
+
+/**
+ * Computes the length of the shortest encoding without comparing block by block:
+ * omitting leading 0s (and 1s) blocks, we need all blocks up to the most significant
+ * one that differs from the sign, which we get by counting the leading sign bits.
+ * We need one extra block, if the first block would not mark the sign correctly, i.e.,
+ * if it is all 1s for a positive value (so we prepend '+') or not all 1s for a negative
+ * value (so we prepend '-'). An encoding of full length never needs an extra block,
+ * since there is no omitted bit left to fill.
+ *
+ * @param value the input, sign-extended from its bit size to the full type
+ * @return the number of characters of the encoding
+ */
+template <size_t Bits, typename T> constexpr size_t encodedLength(T value) {
+    using U = std::conditional_t<sizeof(T) == 16, unsigned __int128, uint64_t>;
+    auto sign = value >> (sizeof(T) * 8 - 1);
+    auto length = (significantBits(static_cast<U>(value ^ sign)) + 5) / 6;
+    auto top = static_cast<uint8_t>(value >> 6 * (length - 1) & 0x3f);
+    length += (top == 0x3f) != (sign != 0);
+    return length < maxLength(Bits) ? length : maxLength(Bits);
+}
+
+/**
+ * Checks, that valid characters encode a value of the given bit size, i.e., that there
+ * are not too many of them and that a full-length encoding does not overflow.
+ *
+ * @param first start of the non-empty encoded input
+ * @param size number of characters
+ * @param bitSize length of the originally encoded input
+ * @param dec the block of every 7-bit character of the alphabet
+ * @return the end of the input, or ERROR::TOO_LONG and its position
+ */
+template <typename Table>
+constexpr from_chars_result checkLength(const char *first, size_t size, size_t bitSize,
+                                        const Table &dec) {
+    size_t maxSize = maxLength(bitSize);
+    if (size > maxSize) {
+        return {first + maxSize, ERROR::TOO_LONG};
+    } else if (size == maxSize && bitSize % 6) {
+        auto rest = bitSize % 6;
+        size_t top = static_cast<uint8_t>(dec[static_cast<uint8_t>(*first)]);
+        size_t usedBits = (1 << rest) - 1;
+        // detect sign, then check consistency of unused bits
+        if (top & 1 << (rest - 1) ? (top | usedBits) != 0x3f : top & ~usedBits) {
+            return {first, ERROR::TOO_LONG};
+        }
+    }
+    return {first + size, ERROR::OK};
+}
+
+} // namespace rules
+
+/**
+ * Determines whether the call is evaluated at compile time, where basic_codec cannot
+ * forward to the library.
+ */
+constexpr bool isConstantEvaluated() {
+#ifdef __cpp_lib_is_constant_evaluated
+    return std::is_constant_evaluated();
+#else
+    return __builtin_is_constant_evaluated();
+#endif
+}
+
+/**
+ * The encoding with a custom alphabet, e.g., for cookies, file names or XML attributes,
+ * which need another set of safe characters. Its functions work like those in san.h,
+ * which are basic_codec<default_alphabet>, i.e., this forwards to them (and the kernels
+ * optimized for the default alphabet), while other alphabets use tables generated at
+ * compile time, like the scalar kernel does, but not its vector paths, so they are slower.
+ * Both follow the same rules for the lengths and the validation, see namespace rules.
+ *
+ * All functions but those returning strings are constexpr, i.e., evaluate at compile time
+ * for constant inputs, where the default alphabet uses the tables as well.
+ *
+ * @tparam Alphabet a type like default_alphabet, with 64 characters in `chars`
+ * @tparam HeaderOnly whether to use the tables for the default alphabet at runtime, too,
+ * instead of forwarding to the library, which inlines the functions into the callers
+ */
+template <typename Alphabet, bool HeaderOnly = false> class basic_codec {
+    static_assert(isAlphabet(Alphabet::chars),
+                  "an alphabet needs 64 distinct, printable 7-bit characters");
+
+    static constexpr bool FORWARD = std::is_same<Alphabet, default_alphabet>::value && !HeaderOnly;
+
+  public:
+    /**
+     * The character of every block.
+     */
+    static constexpr const char (&enc)[65] = Alphabet::chars;
+
+    /**
+     * The block of every 7-bit character, or 64 for characters outside of the alphabet.
+     */
+    static constexpr std::array<uint8_t, 128> dec = makeDecodeTable(Alphabet::chars);
+
+    /**
+     * Determines whether the character is part of the alphabet.
+     */
+    static constexpr bool contains(char c) {
+        return static_cast<uint8_t>(c) < 128 && dec[static_cast<uint8_t>(c)] < 64;
+    }
+
+    /**
+     * See san::valid().
+     */
+    static constexpr ERROR valid(std::string_view input, size_t bitSize = 0) {
+        uint64_t res = 0;
+        return decodeChecked(input.data(), input.data() + input.size(), bitSize, res).ec;
+    }
+
+    // encoders, see encode24Signed() etc. in san.h
+
+    static constexpr to_chars_result encode24Signed(char *first, char *last, int32_t input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::encode24Signed(first, last, input);
+            }
+        }
+        return encodeBlocks<24>(first, last, extend<24>(input));
+    }
+
+    static constexpr to_chars_result encode24(char *first, char *last, uint32_t input) {
+        return encode24Signed(first, last, static_cast<int32_t>(input));
+    }
+
+    static std::string encode24Signed(int32_t input) { return encodeString<24>(input); }
+
+    static std::string encode24(uint32_t input) { return encodeString<24>(input); }
+
+    static constexpr to_chars_result encode32Signed(char *first, char *last, int32_t input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::encode32Signed(first, last, input);
+            }
+        }
+        return encodeBlocks<32>(first, last, static_cast<int64_t>(input));
+    }
+
+    static constexpr to_chars_result encode32(char *first, char *last, uint32_t input) {
+        return encode32Signed(first, last, static_cast<int32_t>(input));
+    }
+
+    static std::string encode32Signed(int32_t input) { return encodeString<32>(input); }
+
+    static std::string encode32(uint32_t input) { return encodeString<32>(input); }
+
+    static constexpr to_chars_result encode48Signed(char *first, char *last, int64_t input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::encode48Signed(first, last, input);
+            }
+        }
+        return encodeBlocks<48>(first, last, extend<48>(input));
+    }
+
+    static constexpr to_chars_result encode48(char *first, char *last, uint64_t input) {
+        return encode48Signed(first, last, static_cast<int64_t>(input));
+    }
+
+    static std::string encode48Signed(int64_t input) { return encodeString<48>(input); }
+
+    static std::string encode48(uint64_t input) { return encodeString<48>(input); }
+
+    static constexpr to_chars_result encode64Signed(char *first, char *last, int64_t input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::encode64Signed(first, last, input);
+            }
+        }
+        return encodeBlocks<64>(first, last, input);
+    }
+
+    static constexpr to_chars_result encode64(char *first, char *last, uint64_t input) {
+        return encode64Signed(first, last, static_cast<int64_t>(input));
+    }
+
+    static std::string encode64Signed(int64_t input) { return encodeString<64>(input); }
+
+    static std::string encode64(uint64_t input) { return encodeString<64>(input); }
+
+    static constexpr to_chars_result encode128Signed(char *first, char *last, int64_t ab,
+                                                     int64_t cd) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::encode128Signed(first, last, ab, cd);
+            }
+        }
+        return encodeBlocks<128>(first, last, join(ab, cd));
+    }
+
+    static constexpr to_chars_result encode128(char *first, char *last, uint64_t ab,
+                                               uint64_t cd) {
+        return encode128Signed(first, last, static_cast<int64_t>(ab), static_cast<int64_t>(cd));
+    }
+
+    static std::string encode128Signed(int64_t ab, int64_t cd) {
+        char buffer[maxLength(128)];
+        return {buffer, encode128Signed(buffer, buffer + sizeof(buffer), ab, cd).ptr};
+    }
+
+    static std::string encode128(uint64_t ab, uint64_t cd) {
+        return encode128Signed(static_cast<int64_t>(ab), static_cast<int64_t>(cd));
+    }
+
+    // decoders, see decode24() etc. in san.h
+
+    static constexpr uint32_t decode24(std::string_view input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode24(input);
+            }
+        }
+        return static_cast<uint32_t>(decodeUnchecked<uint64_t>(input)) & ((1u << 24) - 1);
+    }
+
+    static constexpr from_chars_result decode24(const char *first, const char *last,
+                                                 uint32_t &output) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode24(first, last, output);
+            }
+        }
+        return decodeWidth<24>(first, last, output);
+    }
+
+    static constexpr uint32_t decode32(std::string_view input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode32(input);
+            }
+        }
+        return static_cast<uint32_t>(decodeUnchecked<uint64_t>(input));
+    }
+
+    static constexpr from_chars_result decode32(const char *first, const char *last,
+                                                 uint32_t &output) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode32(first, last, output);
+            }
+        }
+        return decodeWidth<32>(first, last, output);
+    }
+
+    static constexpr uint64_t decode48(std::string_view input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode48(input);
+            }
+        }
+        return decodeUnchecked<uint64_t>(input) & ((uint64_t{1} << 48) - 1);
+    }
+
+    static constexpr from_chars_result decode48(const char *first, const char *last,
+                                                 uint64_t &output) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode48(first, last, output);
+            }
+        }
+        return decodeWidth<48>(first, last, output);
+    }
+
+    static constexpr uint64_t decode64(std::string_view input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode64(input);
+            }
+        }
+        return decodeUnchecked<uint64_t>(input);
+    }
+
+    static constexpr from_chars_result decode64(const char *first, const char *last,
+                                                 uint64_t &output) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode64(first, last, output);
+            }
+        }
+        return decodeWidth<64>(first, last, output);
+    }
+
+    static constexpr std::pair<uint64_t, uint64_t> decode128(std::string_view input) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode128(input);
+            }
+        }
+        return split(decodeUnchecked<unsigned __int128>(input));
+    }
+
+    static constexpr from_chars_result decode128(const char *first, const char *last,
+                                                 std::pair<uint64_t, uint64_t> &output) {
+        if constexpr (FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode128(first, last, output);
+            }
+        }
+        unsigned __int128 res = 0;
+        auto result = decodeChecked(first, last, 128, res);
+        if (result.ec == ERROR::OK) {
+            output = split(res);
+        }
+        return result;
+    }
+
+    // any width from 1 to 128 bits, the ones above for theirs
+
+    /**
+     * Encodes the lowest Bits bits of the input, like the encoders of fixed widths do, so
+     * a value needs at most maxLength(Bits) characters.
+     */
+    template <size_t Bits, bool Signed = false>
+    static constexpr to_chars_result encode(char *first, char *last,
+                                            value_t<Bits, Signed> input) {
+        static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+        if constexpr (Bits == 24) {
+            return encode24Signed(first, last, static_cast<int32_t>(input));
+        } else if constexpr (Bits == 32) {
+            return encode32Signed(first, last, static_cast<int32_t>(input));
+        } else if constexpr (Bits == 48) {
+            return encode48Signed(first, last, static_cast<int64_t>(input));
+        } else if constexpr (Bits == 64) {
+            return encode64Signed(first, last, static_cast<int64_t>(input));
+        } else if constexpr (Bits == 128) {
+            if constexpr (FORWARD) {
+                if (!isConstantEvaluated()) {
+                    return san::encode128Signed(first, last, static_cast<__int128>(input));
+                }
+            }
+            return encodeBlocks<128>(first, last, static_cast<__int128>(input));
+        } else if constexpr (Bits < 64) {
+            return encodeBlocks<Bits>(first, last, extend<Bits>(static_cast<int64_t>(input)));
+        } else {
+            return encodeBlocks<Bits>(first, last, extendWide<Bits>(input));
+        }
+    }
+
+    template <size_t Bits, bool Signed = false>
+    static std::string encode(value_t<Bits, Signed> input) {
+        char buffer[maxLength(Bits)];
+        return {buffer, encode<Bits, Signed>(buffer, buffer + sizeof(buffer), input).ptr};
+    }
+
+    /**
+     * Decodes the lowest Bits bits of the input, without any checks.
+     */
+    template <size_t Bits> static constexpr value_t<Bits> decode(std::string_view input) {
+        static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+        if constexpr (Bits == 24) {
+            return decode24(input);
+        } else if constexpr (Bits == 32) {
+            return decode32(input);
+        } else if constexpr (Bits == 48) {
+            return decode48(input);
+        } else if constexpr (Bits == 64) {
+            return decode64(input);
+        } else if constexpr (Bits == 128) {
+            if constexpr (FORWARD) {
+                if (!isConstantEvaluated()) {
+                    return san::decode128Native(input);
+                }
+            }
+            return decodeUnchecked<unsigned __int128>(input);
+        } else if constexpr (Bits < 64) {
+            return static_cast<value_t<Bits>>(decodeUnchecked<uint64_t>(input) &
+                                              mask<Bits, uint64_t>());
+        } else {
+            return decodeUnchecked<unsigned __int128>(input) & mask<Bits, unsigned __int128>();
+        }
+    }
+
+    /**
+     * Decodes a value of Bits bits, if the input is valid<Bits>().
+     */
+    template <size_t Bits>
+    static constexpr from_chars_result decode(const char *first, const char *last,
+                                              value_t<Bits> &output) {
+        static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+        if constexpr (Bits == 24) {
+            return decode24(first, last, output);
+        } else if constexpr (Bits == 32) {
+            return decode32(first, last, output);
+        } else if constexpr (Bits == 48) {
+            return decode48(first, last, output);
+        } else if constexpr (Bits == 64) {
+            return decode64(first, last, output);
+        } else if constexpr (Bits == 128 && FORWARD) {
+            if (!isConstantEvaluated()) {
+                return san::decode128(first, last, output);
+            }
+            return decodeWidth<128>(first, last, output);
+        } else {
+            return decodeWidth<Bits>(first, last, output);
+        }
+    }
+
+    /**
+     * See san::valid(), with the bit size checked at compile time.
+     */
+    template <size_t Bits> static constexpr ERROR valid(std::string_view input) {
+        static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+        return valid(input, Bits);
+    }
+
+    /**
+     * Strips the redundant leading blocks of an encoding, like the encoders omit them, i.e.,
+     * 0s blocks, which are not followed by a 1s block, and 1s blocks, which are (e.g., "++a"
+     * and "--Z" become "a" and "-Z", but "+-" stays). The result is a suffix of the input.
+     */
+    static constexpr std::string_view canonicalize(std::string_view input) {
+        size_t pos = 0;
+        while (pos + 1 < input.size() && redundant(input[pos], input[pos + 1])) {
+            ++pos;
+        }
+        return input.substr(pos);
+    }
+
+    /**
+     * Determines whether the input is a valid<Bits>() encoding without redundant leading
+     * blocks, i.e., the one encode<Bits>() writes for its value.
+     */
+    template <size_t Bits> static constexpr bool isCanonical(std::string_view input) {
+        return valid<Bits>(input) == ERROR::OK && canonicalize(input).size() == input.size();
+    }
+
+  private:
+    /**
+     * Determines whether a leading block can be omitted, given the following one.
+     */
+    static constexpr bool redundant(char c, char next) {
+        return c == enc[0] ? next != enc[63] : c == enc[63] && next == enc[63];
+    }
+
+    /**
+     * Sign-extends the lowest Bits bits of the input to the full 64 bits.
+     */
+    template <size_t Bits> static constexpr int64_t extend(int64_t input) {
+        return static_cast<int64_t>(static_cast<uint64_t>(input) << (64 - Bits)) >> (64 - Bits);
+    }
+
+    template <size_t Bits> static constexpr __int128 extendWide(__int128 input) {
+        return static_cast<__int128>(static_cast<unsigned __int128>(input) << (128 - Bits)) >>
+               (128 - Bits);
+    }
+
+    template <size_t Bits, typename T> static constexpr T mask() {
+        return Bits < sizeof(T) * 8 ? (T{1} << Bits % (sizeof(T) * 8)) - 1 : ~T{0};
+    }
+
+    static constexpr __int128 join(int64_t ab, int64_t cd) {
+        return static_cast<__int128>(static_cast<unsigned __int128>(static_cast<uint64_t>(ab))
+                                         << 64 |
+                                     static_cast<uint64_t>(cd));
+    }
+
+    static constexpr std::pair<uint64_t, uint64_t> split(unsigned __int128 value) {
+        return {static_cast<uint64_t>(value >> 64), static_cast<uint64_t>(value)};
+    }
+
+    /**
+     * Encodes the input like the kernels do, see encodeBlocks() in kernel.cpp: all blocks
+     * are looked up, and only the shortest encoding (see rules::encodedLength()) is copied,
+     * in a loop guarded by the length, so both loops have a trip count known at compile time.
+     *
+     * @param input the value, sign-extended from its bit size to the full type
+     */
+    template <size_t Bits, typename T>
+    static constexpr to_chars_result encodeBlocks(char *first, char *last, T input) {
+        constexpr size_t size = maxLength(Bits);
+        char blocks[size]{};
+        for (size_t i = 0; i < size; ++i) {
+            blocks[i] = enc[static_cast<uint8_t>(input >> 6 * (size - 1 - i)) & 0x3f];
+        }
+        auto length = rules::encodedLength<Bits>(input);
+        if (static_cast<size_t>(last - first) < length) {
+            return {last, ERROR::NO_SPACE};
+        }
+        auto start = blocks + size - length;
+        for (size_t i = 0; i < size; ++i) {
+            if (i < length) {
+                first[i] = start[i];
+            }
+        }
+        return {first + length, ERROR::OK};
+    }
+
+    template <size_t Bits, typename T> static std::string encodeString(T input) {
+        char buffer[maxLength(Bits)];
+        to_chars_result res{};
+        if constexpr (Bits == 24) {
+            res = encode24Signed(buffer, buffer + sizeof(buffer), static_cast<int32_t>(input));
+        } else if constexpr (Bits == 32) {
+            res = encode32Signed(buffer, buffer + sizeof(buffer), static_cast<int32_t>(input));
+        } else if constexpr (Bits == 48) {
+            res = encode48Signed(buffer, buffer + sizeof(buffer), static_cast<int64_t>(input));
+        } else {
+            res = encode64Signed(buffer, buffer + sizeof(buffer), static_cast<int64_t>(input));
+        }
+        return {buffer, res.ptr};
+    }
+
+    /**
+     * Decodes and validates the input, see decodeChecked() in kernel.cpp.
+     */
+    template <typename T>
+    static constexpr from_chars_result decodeChecked(const char *first, const char *last,
+                                                     size_t bitSize, T &res) {
+        if (first == last) {
+            return {first, ERROR::EMPTY};
+        }
+        res = *first == enc[0x3f] ? ~T{0} : T{0};
+        for (auto pos = first; pos != last; ++pos) {
+            auto byte = static_cast<uint8_t>(*pos);
+            if (byte >= 128) {
+                return {pos, ERROR::HIGH_BIT};
+            } else if (dec[byte] >= 64) {
+                return {pos, ERROR::WRONG_CHAR};
+            }
+            res = res << 6 | dec[byte];
+        }
+        auto size = static_cast<size_t>(last - first);
+        return bitSize ? rules::checkLength(first, size, bitSize, dec)
+                       : from_chars_result{last, ERROR::OK};
+    }
+
+    template <size_t Bits, typename T>
+    static constexpr from_chars_result decodeWidth(const char *first, const char *last,
+                                                   T &output) {
+        using Wide = std::conditional_t<(Bits > 64), unsigned __int128, uint64_t>;
+        Wide res = 0;
+        auto result = decodeChecked(first, last, Bits, res);
+        if (result.ec == ERROR::OK) {
+            output = static_cast<T>(res & mask<Bits, Wide>());
+        }
+        return result;
+    }
+
+    template <typename T> static constexpr T decodeUnchecked(std::string_view input) {
+        T res = !input.empty() && input[0] == enc[0x3f] ? ~T{0} : T{0};
+        for (auto c : input) {
+            res = res << 6 | dec[static_cast<uint8_t>(c) & 0x7f];
+        }
+        return res;
+    }
+};
+
+/**
+ * The encoding with the default alphabet, i.e., the functions in san.h, or their inline
+ * versions, if SAN_HEADER_ONLY is defined, which need no library to link.
+ */
+#ifdef SAN_HEADER_ONLY
+using codec = basic_codec<default_alphabet, true>;
+#else
+using codec = basic_codec<default_alphabet>;
+#endif
+
+/**
+ * Encodes the lowest Bits bits of the input, e.g., a 16-bit port or a 40-bit field, in
+ * at most maxLength(Bits) characters. The widths of san.h encode like their functions.
+ */
+template <size_t Bits, bool Signed = false>
+constexpr to_chars_result encode(char *first, char *last, value_t<Bits, Signed> input) {
+    return codec::encode<Bits, Signed>(first, last, input);
+}
+
+template <size_t Bits, bool Signed = false> std::string encode(value_t<Bits, Signed> input) {
+    return codec::encode<Bits, Signed>(input);
+}
+
+/**
+ * Decodes the lowest Bits bits of the input, without any checks.
+ */
+template <size_t Bits> constexpr value_t<Bits> decode(std::string_view input) {
+    return codec::decode<Bits>(input);
+}
+
+/**
+ * Decodes a value of Bits bits, if the input is valid<Bits>(), see from_chars_result.
+ */
+template <size_t Bits>
+constexpr from_chars_result decode(const char *first, const char *last, value_t<Bits> &output) {
+    return codec::decode<Bits>(first, last, output);
+}
+
+/**
+ * See valid(), with the bit size checked at compile time.
+ */
+template <size_t Bits> constexpr ERROR valid(std::string_view input) {
+    return codec::valid<Bits>(input);
+}
+
+/**
+ * Strips the redundant leading blocks of an encoding, see basic_codec::canonicalize().
+ */
+constexpr std::string_view canonicalize(std::string_view input) {
+    return codec::canonicalize(input);
+}
+
+/**
+ * Determines whether the input is the encoding, which encode<Bits>() writes, i.e., a
+ * valid<Bits>() one without redundant leading blocks.
+ */
+template <size_t Bits> constexpr bool isCanonical(std::string_view input) {
+    return codec::isCanonical<Bits>(input);
+}
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+/**
+ * A string literal as the argument of a template, see the literals below.
+ */
+template <size_t N> struct fixed_string {
+    char chars[N]{};
+
+    constexpr fixed_string(const char (&literal)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            chars[i] = literal[i];
+        }
+    }
+};
+
+/**
+ * The characters of a literal, with static storage to be used in constant expressions.
+ */
+template <fixed_string Literal> struct LiteralChars {
+    static constexpr std::string_view input{Literal.chars, sizeof(Literal.chars) - 1};
+};
+#elif defined(__GNUC__)
+/**
+ * The characters of a literal, with static storage to be used in constant expressions.
+ */
+template <typename C, C... Chars> struct LiteralChars {
+    static_assert(std::is_same<C, char>::value, "SAN literals are narrow strings");
+    static constexpr char chars[] = {Chars..., '\0'};
+    static constexpr std::string_view input{chars, sizeof...(Chars)};
+};
+#endif
+
+/**
+ * Decodes a literal of the given width at compile time, which fails to compile, if it is
+ * no valid encoding of the width.
+ *
+ * @tparam Literal the LiteralChars of the literal
+ */
+template <size_t Bits, typename T, typename Literal> constexpr T decodeLiteral() {
+    constexpr auto input = Literal::input;
+    static_assert(codec::valid(input, Bits) == ERROR::OK, "not a SAN encoding of the width");
+    if constexpr (Bits == 128) {
+        constexpr T value = codec::decode128(input);
+        return value;
+    } else {
+        constexpr T value = Bits == 24   ? codec::decode24(input)
+                            : Bits == 32 ? codec::decode32(input)
+                            : Bits == 48 ? codec::decode48(input)
+                                         : codec::decode64(input);
+        return value;
+    }
+}
+
+namespace literals {
+
+/**
+ * Literals of values as their encodings, e.g., "aqz+"_san32 == 0x29a8c0, which are decoded
+ * at compile time, and do not compile, if they are no valid encoding of the width.
+ *
+ * They take the literal as a class type template argument since C++20. Before, they are
+ * string literal operator templates, a GNU extension (GCC and Clang), whose -Wpedantic
+ * warnings we suppress here, and there are no literals with other compilers.
+ */
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+template <fixed_string Literal> constexpr uint32_t operator""_san24() {
+    return decodeLiteral<24, uint32_t, LiteralChars<Literal>>();
+}
+
+template <fixed_string Literal> constexpr uint32_t operator""_san32() {
+    return decodeLiteral<32, uint32_t, LiteralChars<Literal>>();
+}
+
+template <fixed_string Literal> constexpr uint64_t operator""_san48() {
+    return decodeLiteral<48, uint64_t, LiteralChars<Literal>>();
+}
+
+template <fixed_string Literal> constexpr uint64_t operator""_san64() {
+    return decodeLiteral<64, uint64_t, LiteralChars<Literal>>();
+}
+
+template <fixed_string Literal> constexpr std::pair<uint64_t, uint64_t> operator""_san128() {
+    return decodeLiteral<128, std::pair<uint64_t, uint64_t>, LiteralChars<Literal>>();
+}
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+#endif
+template <typename C, C... Chars> constexpr uint32_t operator""_san24() {
+    return decodeLiteral<24, uint32_t, LiteralChars<C, Chars...>>();
+}
+
+template <typename C, C... Chars> constexpr uint32_t operator""_san32() {
+    return decodeLiteral<32, uint32_t, LiteralChars<C, Chars...>>();
+}
+
+template <typename C, C... Chars> constexpr uint64_t operator""_san48() {
+    return decodeLiteral<48, uint64_t, LiteralChars<C, Chars...>>();
+}
+
+template <typename C, C... Chars> constexpr uint64_t operator""_san64() {
+    return decodeLiteral<64, uint64_t, LiteralChars<C, Chars...>>();
+}
+
+template <typename C, C... Chars> constexpr std::pair<uint64_t, uint64_t> operator""_san128() {
+    return decodeLiteral<128, std::pair<uint64_t, uint64_t>, LiteralChars<C, Chars...>>();
+}
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace literals
+
+} // namespace san
+
+#endif // LIBSAN_SAN_CODEC_H
@@ -0,0 +1,221 @@
+#ifndef LIBSAN_SAN_ENCODED_H
+#define LIBSAN_SAN_ENCODED_H
+
+#include <functional>
+#include <sanCodec.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace san {
+
+/**
+ * An encoding of a value of the given width, stored inline with its length, e.g., in 5
+ * bytes for 24 bit, 12 bytes for 64 bit and 23 bytes for 128 bit, instead of a string's
+ * 32 bytes plus a heap block. It is trivially copyable, so tables of encoded keys can be
+ * flat arrays, which are copied, moved and compared without heap traffic.
+ *
+ * The order is the one of the characters, i.e., of the encodings as strings, not the one
+ * of the values, so it can replace string keys as is.
+ *
+ * @tparam Bits the width of the values, from 1 to 128 bits
+ */
+template <size_t Bits> class Encoded {
+    static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+
+  public:
+    /**
+     * An empty encoding, which is no valid one, e.g., to initialize arrays.
+     */
+    constexpr Encoded() = default;
+
+    /**
+     * Encodes the lowest Bits bits of the input, see san::encode<Bits, Signed>().
+     */
+    template <bool Signed = false> static constexpr Encoded encode(value_t<Bits, Signed> input) {
+        Encoded res;
+        auto end = codec::encode<Bits, Signed>(res.chars, res.chars + capacity(), input).ptr;
+        res.length = static_cast<uint8_t>(end - res.chars);
+        return res;
+    }
+
+    /**
+     * Encodes consecutive values, see san::encodeRange(). The last character of an
+     * encoding runs through the alphabet until it carries, so runs of up to 64 encodings
+     * are copies of one, which differ in that character, and only the carries increment.
+     */
+    template <bool Signed = false>
+    static constexpr void encodeRange(value_t<Bits, Signed> start, size_t count, Encoded *out) {
+        if (count == 0) {
+            return;
+        }
+        auto current = encode<Signed>(start);
+        for (size_t i = 0;;) {
+            size_t last = current.length - 1;
+            size_t block = codec::dec[static_cast<uint8_t>(current.chars[last])];
+            // a '-' must not become the sign, or follow it, and a single block may wrap
+            size_t end = 64;
+            if (last == 0 || (last == 1 && current.chars[0] == codec::enc[0x3f])) {
+                end = last == 0 && current.length == capacity() ? block + 1 : 0x3f;
+                end = end > block ? end : block + 1;
+            }
+            auto run = count - i < end - block ? count - i : end - block;
+            for (size_t k = 0; k < run; ++k) {
+                out[i + k] = current;
+                out[i + k].chars[last] = codec::enc[block + k];
+            }
+            i += run;
+            if (i == count) {
+                return;
+            }
+            current = out[i - 1];
+            ++current;
+        }
+    }
+
+    /**
+     * Decodes the value, see san::decode<Bits>().
+     */
+    constexpr value_t<Bits> decode() const { return codec::decode<Bits>(view()); }
+
+    /**
+     * Replaces the encoding with the one of the next value, i.e., of decode() + 1, which
+     * wraps around at the width, like the values. Usually, only the last character changes:
+     * the blocks are carried through the alphabet in place, from the last one, which is no
+     * '-' block, so only the growth by one character (e.g., from "0" to "+-") and the sign
+     * boundaries (e.g., from "-" to "+" or from "-0-" to "-+", which omits the leading '-')
+     * are encoded again.
+     *
+     * The encoding must be a canonical, non-empty one, e.g., from encode().
+     */
+    constexpr Encoded &operator++() {
+        if constexpr (capacity() == 1) {
+            // a single block always wraps at the width
+            return *this = encode(static_cast<value_t<Bits>>(decode() + 1));
+        }
+        auto last = static_cast<size_t>(length - 1);
+        auto pos = last;
+        while (pos && chars[pos] == codec::enc[0x3f]) {
+            --pos;
+        }
+        auto block = codec::dec[static_cast<uint8_t>(chars[pos])];
+        bool grows = pos == 0 && (block >= 0x3e || length == capacity());
+        bool shrinks = pos == 1 && block == 0x3e && chars[0] == codec::enc[0x3f];
+        if (grows || shrinks) {
+            return *this = encode(static_cast<value_t<Bits>>(decode() + 1));
+        }
+        chars[pos] = codec::enc[block + 1];
+        while (pos != last) {
+            chars[++pos] = codec::enc[0];
+        }
+        return *this;
+    }
+
+    /**
+     * Copies a valid encoding of the width, see valid<Bits>().
+     *
+     * @param first start of the encoded input
+     * @param last end of the encoded input
+     * @param output receives the encoding, only written on success
+     * @return the end of the input, or the error and its position
+     */
+    friend constexpr from_chars_result from_chars(const char *first, const char *last,
+                                                  Encoded &output) {
+        value_t<Bits> ignored{};
+        auto result = codec::decode<Bits>(first, last, ignored);
+        if (result.ec == ERROR::OK) {
+            for (auto pos = first; pos != last; ++pos) {
+                output.chars[pos - first] = *pos;
+            }
+            output.length = static_cast<uint8_t>(last - first);
+        }
+        return result;
+    }
+
+    static constexpr size_t capacity() { return maxLength(Bits); }
+
+    constexpr size_t size() const { return length; }
+
+    constexpr bool empty() const { return length == 0; }
+
+    constexpr const char *data() const { return chars; }
+
+    constexpr const char *begin() const { return chars; }
+
+    constexpr const char *end() const { return chars + length; }
+
+    constexpr std::string_view view() const { return {chars, length}; }
+
+    constexpr operator std::string_view() const { return view(); }
+
+    std::string str() const { return {chars, length}; }
+
+    friend constexpr bool operator==(const Encoded &a, const Encoded &b) {
+        return a.view() == b.view();
+    }
+
+    friend constexpr bool operator!=(const Encoded &a, const Encoded &b) { return !(a == b); }
+
+    friend constexpr bool operator<(const Encoded &a, const Encoded &b) {
+        return a.view() < b.view();
+    }
+
+    friend constexpr bool operator>(const Encoded &a, const Encoded &b) { return b < a; }
+
+    friend constexpr bool operator<=(const Encoded &a, const Encoded &b) { return !(b < a); }
+
+    friend constexpr bool operator>=(const Encoded &a, const Encoded &b) { return !(a < b); }
+
+  private:
+    char chars[maxLength(Bits)]{};
+    uint8_t length = 0;
+};
+
+/**
+ * Encodes the lowest Bits bits of the input into an inline encoding, see Encoded.
+ */
+template <size_t Bits, bool Signed = false>
+constexpr Encoded<Bits> encodeInline(value_t<Bits, Signed> input) {
+    return Encoded<Bits>::template encode<Signed>(input);
+}
+
+/**
+ * Replaces a canonical encoding with the one of the next value, see Encoded::operator++().
+ */
+template <size_t Bits> constexpr void increment(Encoded<Bits> &encoded) { ++encoded; }
+
+/**
+ * Encodes consecutive values, i.e., start, start + 1, ..., start + count - 1, which wrap
+ * around at the width, like encoding each of them, see encodeInline(). Only the first
+ * value is encoded, the others are incremented from their predecessor, so runs of
+ * sequential IDs mostly cost a copy and a character each, see Encoded::encodeRange().
+ *
+ * @param start the first value
+ * @param count the number of values
+ * @param out receives count encodings
+ */
+template <size_t Bits, bool Signed = false>
+constexpr void encodeRange(value_t<Bits, Signed> start, size_t count, Encoded<Bits> *out) {
+    Encoded<Bits>::template encodeRange<Signed>(start, count, out);
+}
+
+static_assert(std::is_trivially_copyable<Encoded<128>>::value);
+static_assert(sizeof(Encoded<24>) == 5 && sizeof(Encoded<64>) == 12 &&
+              sizeof(Encoded<128>) == 23);
+
+} // namespace san
+
+namespace std {
+
+/**
+ * Hashes the characters, like the hash of the encoding as a string.
+ */
+template <size_t Bits> struct hash<san::Encoded<Bits>> {
+    size_t operator()(const san::Encoded<Bits> &encoded) const {
+        return hash<string_view>()(encoded.view());
+    }
+};
+
+} // namespace std
+
+#endif // LIBSAN_SAN_ENCODED_H
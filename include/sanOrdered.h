@@ -0,0 +1,216 @@
+#ifndef LIBSAN_SAN_ORDERED_H
+#define LIBSAN_SAN_ORDERED_H
+
+#include <sanCodec.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace san {
+
+/**
+ * The alphabet of the order-preserving encoding, in ASCII order, i.e., the characters of
+ * base64url, sorted.
+ */
+struct ordered_alphabet {
+    static constexpr char chars[65] =
+        "-0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+};
+
+/**
+ * An encoding, which sorts like the values, byte by byte (e.g., with memcmp or as strings),
+ * so range scans over encoded keys need not decode them.
+ *
+ * The first character tells the sign and the number of blocks, which follow it in the
+ * ordered alphabet: for signed values, prefix M - 1 + n marks a non-negative value of n
+ * blocks and M - n a negative one, where M is maxLength(Bits), so more blocks sort before
+ * fewer for negative values and after them otherwise. For unsigned values, prefix n - 1
+ * marks n blocks. Like the default encoding, leading 0s (and for negative values 1s)
+ * blocks are omitted, so an encoding is at most one character longer, e.g., "A-" for 0
+ * and "9_" for -27 as signed 64 bit values, and "10--" for 2^12 as an unsigned one.
+ */
+template <size_t Bits, bool Signed> class ordered_codec {
+    static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+
+    using codec = basic_codec<ordered_alphabet>;
+    using T = value_t<Bits, Signed>;
+    using U = std::conditional_t<(Bits > 64), unsigned __int128, uint64_t>;
+    // like value_t, since std::make_signed does not take __int128 in strict modes
+    using S = std::conditional_t<(Bits > 64), __int128, int64_t>;
+
+    static constexpr size_t BLOCKS = san::maxLength(Bits);
+    static constexpr size_t WIDTH = sizeof(U) * 8;
+
+  public:
+    /**
+     * The maximum length of an encoding, i.e., the blocks of a full value and the prefix.
+     */
+    static constexpr size_t maxLength() { return BLOCKS + 1; }
+
+    /**
+     * Encodes the lowest Bits bits of the input.
+     *
+     * @param first start of the output buffer
+     * @param last end of the output buffer, maxLength() characters are always enough
+     * @param input the value
+     * @return the end of the encoding, or ERROR::NO_SPACE
+     */
+    static constexpr to_chars_result encode(char *first, char *last, T input) {
+        auto value = static_cast<U>(input);
+        if constexpr (Signed) {
+            value = static_cast<U>(static_cast<S>(value << (WIDTH - Bits)) >> (WIDTH - Bits));
+        } else if constexpr (Bits < WIDTH) {
+            value &= (U{1} << Bits) - 1;
+        }
+        bool negative = Signed && value >> (WIDTH - 1);
+        auto blocks = (rules::significantBits(negative ? ~value : value) + 5) / 6;
+        if (static_cast<size_t>(last - first) < blocks + 1) {
+            return {last, ERROR::NO_SPACE};
+        }
+        first[0] = codec::enc[prefix(negative, blocks)];
+        // a negative first block is filled with 1s, like the sign of the default encoding
+        for (size_t i = 0; i < blocks; ++i) {
+            auto shift = 6 * (blocks - 1 - i);
+            auto block = value >> shift;
+            if constexpr (Signed) {
+                block = static_cast<U>(static_cast<S>(value) >> shift);
+            }
+            first[1 + i] = codec::enc[static_cast<uint8_t>(block) & 0x3f];
+        }
+        return {first + blocks + 1, ERROR::OK};
+    }
+
+    static std::string encode(T input) {
+        char buffer[maxLength()];
+        return {buffer, encode(buffer, buffer + sizeof(buffer), input).ptr};
+    }
+
+    /**
+     * Decodes the input without any checks.
+     */
+    static constexpr T decode(std::string_view input) {
+        if (input.empty()) {
+            return 0;
+        }
+        bool negative = Signed && codec::dec[static_cast<uint8_t>(input[0]) & 0x7f] < BLOCKS;
+        auto res = negative ? ~U{0} : U{0};
+        for (auto c : input.substr(1)) {
+            res = res << 6 | codec::dec[static_cast<uint8_t>(c) & 0x7f];
+        }
+        return static_cast<T>(res);
+    }
+
+    /**
+     * Decodes the input, if it is valid().
+     *
+     * @param first start of the encoded input
+     * @param last end of the encoded input
+     * @param output the decoded value, only written on success
+     * @return the end of the input, or the error and its position
+     */
+    static constexpr from_chars_result decode(const char *first, const char *last, T &output) {
+        auto result = check(first, last);
+        if (result.ec == ERROR::OK) {
+            output = decode({first, static_cast<size_t>(last - first)});
+        }
+        return result;
+    }
+
+    /**
+     * Determines whether the input is an encoding of a value of the width, i.e., besides
+     * the characters of the alphabet: a prefix for at most maxLength(Bits) blocks, as many
+     * blocks as it tells (ERROR::TOO_LONG or ERROR::TOO_SHORT), no omissible leading
+     * block, and a first block, which fits the width, if there are maxLength(Bits) blocks
+     * (ERROR::TOO_LONG at the first block). So every value has exactly one encoding.
+     */
+    static constexpr ERROR valid(std::string_view input) {
+        return check(input.data(), input.data() + input.size()).ec;
+    }
+
+  private:
+    static constexpr size_t prefix(bool negative, size_t blocks) {
+        if constexpr (Signed) {
+            return negative ? BLOCKS - blocks : BLOCKS - 1 + blocks;
+        } else {
+            return blocks - 1;
+        }
+    }
+
+    static constexpr from_chars_result check(const char *first, const char *last) {
+        if (first == last) {
+            return {first, ERROR::EMPTY};
+        }
+        for (auto pos = first; pos != last; ++pos) {
+            if (static_cast<uint8_t>(*pos) >= 128) {
+                return {pos, ERROR::HIGH_BIT};
+            } else if (!codec::contains(*pos)) {
+                return {pos, ERROR::WRONG_CHAR};
+            }
+        }
+        size_t code = codec::dec[static_cast<uint8_t>(*first)];
+        if (code >= (Signed ? 2 * BLOCKS : BLOCKS)) {
+            return {first, ERROR::TOO_LONG};
+        }
+        bool negative = Signed && code < BLOCKS;
+        auto blocks = Signed ? (negative ? BLOCKS - code : code + 1 - BLOCKS) : code + 1;
+        auto size = static_cast<size_t>(last - first) - 1;
+        if (size != blocks) {
+            return {size > blocks ? first + 1 + blocks : last,
+                    size > blocks ? ERROR::TOO_LONG : ERROR::TOO_SHORT};
+        }
+
+        // the first block must not be omissible, and must fit the width, i.e., for signed
+        // values, its highest used bit must be the sign, which the prefix tells
+        size_t top = codec::dec[static_cast<uint8_t>(first[1])];
+        size_t fill = negative ? 0x3f : 0;
+        auto rest = Bits % 6;
+        auto used = rest ? rest : 6;
+        if ((blocks > 1 && top == fill) ||
+            (blocks == BLOCKS && (Signed ? (top ^ fill) >> (used - 1) : top >> used))) {
+            return {first + 1, ERROR::TOO_LONG};
+        }
+        return {last, ERROR::OK};
+    }
+};
+
+/**
+ * Encodes the lowest Bits bits of the input, so the encodings sort like the values, see
+ * ordered_codec.
+ */
+template <size_t Bits, bool Signed = false>
+constexpr to_chars_result encodeOrdered(char *first, char *last, value_t<Bits, Signed> input) {
+    return ordered_codec<Bits, Signed>::encode(first, last, input);
+}
+
+template <size_t Bits, bool Signed = false>
+std::string encodeOrdered(value_t<Bits, Signed> input) {
+    return ordered_codec<Bits, Signed>::encode(input);
+}
+
+/**
+ * Decodes an order-preserving encoding without any checks.
+ */
+template <size_t Bits, bool Signed = false>
+constexpr value_t<Bits, Signed> decodeOrdered(std::string_view input) {
+    return ordered_codec<Bits, Signed>::decode(input);
+}
+
+/**
+ * Decodes an order-preserving encoding, if it is validOrdered(), see from_chars_result.
+ */
+template <size_t Bits, bool Signed = false>
+constexpr from_chars_result decodeOrdered(const char *first, const char *last,
+                                          value_t<Bits, Signed> &output) {
+    return ordered_codec<Bits, Signed>::decode(first, last, output);
+}
+
+/**
+ * Validates an order-preserving encoding, see ordered_codec::valid().
+ */
+template <size_t Bits, bool Signed = false> constexpr ERROR validOrdered(std::string_view input) {
+    return ordered_codec<Bits, Signed>::valid(input);
+}
+
+} // namespace san
+
+#endif // LIBSAN_SAN_ORDERED_H
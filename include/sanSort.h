@@ -0,0 +1,232 @@
+#ifndef LIBSAN_SAN_SORT_H
+#define LIBSAN_SAN_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <sanCodec.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace san {
+
+namespace radix {
+
+/**
+ * The inputs, from which on the passes are split over all cores.
+ */
+constexpr size_t PARALLEL = 1 << 18;
+
+/**
+ * A decoded value with the index of its token, whose key bytes sort like the values.
+ */
+template <size_t Bits> struct Entry {
+    value_t<Bits> key;
+    size_t index;
+};
+
+/**
+ * The number of entries with each byte value, for every byte of the keys.
+ */
+template <size_t Bits> using Counts = std::array<std::array<size_t, 256>, (Bits + 7) / 8>;
+
+/**
+ * Decodes every token once into the key of its entry, with the sign bit flipped for signed
+ * values, so the keys sort like the values as unsigned integers, and counts their bytes.
+ */
+template <size_t Bits, bool Signed, typename Range>
+void decodeKeys(const Range &tokens, size_t first, size_t last, Entry<Bits> *entries,
+                Counts<Bits> &counts) {
+    constexpr auto sign = Signed ? value_t<Bits>{1} << (Bits - 1) : value_t<Bits>{0};
+    for (auto &count : counts) {
+        count.fill(0);
+    }
+    for (auto i = first; i < last; ++i) {
+        auto key = static_cast<value_t<Bits>>(decode<Bits>(std::string_view(tokens[i])) ^ sign);
+        entries[i] = {key, i};
+        for (size_t pass = 0; pass < counts.size(); ++pass) {
+            ++counts[pass][static_cast<uint8_t>(key >> 8 * pass)];
+        }
+    }
+}
+
+/**
+ * Runs the function for consecutive slices of the range [0, n), one per thread.
+ */
+template <typename F> void forSlices(size_t n, size_t threads, F &&f) {
+    if (threads == 1) {
+        f(0, 0, n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(f, t, n * t / threads, n * (t + 1) / threads);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * The entries, which scatter() collects per byte before it moves them, i.e., 128 bytes.
+ */
+template <size_t Bits> constexpr size_t LINE = 128 / sizeof(Entry<Bits>);
+
+/**
+ * Moves the entries to the offsets of their bytes. Each byte collects a line of entries in
+ * a small buffer first, so the moves write whole cache lines, instead of touching 256
+ * of them (and their pages) for every few entries, which is bound by memory otherwise.
+ */
+template <size_t Bits, typename F>
+void scatter(const Entry<Bits> *first, const Entry<Bits> *last, Entry<Bits> *out,
+             std::array<size_t, 256> &offsets, F &&byte) {
+    constexpr auto line = LINE<Bits>;
+    std::unique_ptr<Entry<Bits>[]> lines(new Entry<Bits>[256 * line]);
+    std::array<uint8_t, 256> sizes{};
+    for (auto pos = first; pos != last; ++pos) {
+        auto digit = byte(*pos);
+        auto size = sizes[digit];
+        lines[digit * line + size] = *pos;
+        if (size + 1 == line) {
+            std::copy(&lines[digit * line], &lines[digit * line] + line, out + offsets[digit]);
+            offsets[digit] += line;
+            sizes[digit] = 0;
+        } else {
+            sizes[digit] = static_cast<uint8_t>(size + 1);
+        }
+    }
+    for (size_t digit = 0; digit < 256; ++digit) {
+        std::copy(&lines[digit * line], &lines[digit * line] + sizes[digit], out + offsets[digit]);
+    }
+}
+
+/**
+ * Sorts the entries by their keys with an LSD radix sort, one byte per pass, which is
+ * stable, so equal keys keep the order of their tokens. Passes, in which all keys have the
+ * same byte, are skipped, e.g., the high bytes of small values. A single thread takes the
+ * offsets of each pass from the counts of decodeKeys(), several threads count and move the
+ * entries of their slices, at offsets ordered by byte and then by thread.
+ *
+ * @param entries the n entries, receives the sorted ones, which may be the buffer
+ * @param buffer as many entries to move them between the passes
+ * @param counts the counts of all entries
+ */
+template <size_t Bits>
+void sortEntries(Entry<Bits> *&entries, Entry<Bits> *&buffer, size_t n,
+                 const Counts<Bits> &counts, size_t threads) {
+    std::vector<std::array<size_t, 256>> offsets(threads);
+    for (size_t pass = 0; n && pass < counts.size(); ++pass) {
+        auto shift = 8 * pass;
+        auto byte = [shift](const Entry<Bits> &entry) {
+            return static_cast<uint8_t>(entry.key >> shift);
+        };
+        if (counts[pass][byte(entries[0])] == n) {
+            continue;
+        }
+
+        if (threads == 1) {
+            offsets[0] = counts[pass];
+        } else {
+            forSlices(n, threads, [&](size_t t, size_t first, size_t last) {
+                offsets[t].fill(0);
+                for (auto i = first; i < last; ++i) {
+                    ++offsets[t][byte(entries[i])];
+                }
+            });
+        }
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (auto &count : offsets) {
+                auto size = count[digit];
+                count[digit] = offset;
+                offset += size;
+            }
+        }
+        forSlices(n, threads, [&](size_t t, size_t first, size_t last) {
+            scatter<Bits>(entries + first, entries + last, buffer, offsets[t], byte);
+        });
+        std::swap(entries, buffer);
+    }
+}
+
+} // namespace radix
+
+/**
+ * Determines the numeric order of valid encodings of Bits bits, i.e., the order of their
+ * decode<Bits>() values, or of their values as signed integers. Every token is decoded
+ * once into a fixed-width key, which an LSD radix sort orders a byte per pass, in parallel
+ * for large inputs (so this needs to link a thread library, e.g., Threads::Threads).
+ *
+ * @tparam Signed whether to order by the values as signed integers of the width, like
+ * compare64() does, or as unsigned ones
+ * @param tokens a random access range of the encodings, e.g., std::string, std::string_view
+ * or Encoded, which may have redundant leading blocks, e.g., "++a"
+ * @param unique whether to keep the first token of equal values only
+ * @param threads the number of threads, or 0 for all cores from radix::PARALLEL inputs on
+ * @return the indices of the tokens in order, equal values in the order of the tokens
+ */
+template <size_t Bits, bool Signed, typename Range>
+std::vector<size_t> sortEncodedIndex(const Range &tokens, bool unique = false,
+                                     size_t threads = 0) {
+    static_assert(0 < Bits && Bits <= 128, "SAN encodes 1 to 128 bits");
+    auto n = static_cast<size_t>(std::size(tokens));
+    if (threads == 0) {
+        auto cores = static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency()));
+        threads = n < radix::PARALLEL ? 1 : std::min(cores, n / (radix::PARALLEL / 4));
+    }
+
+    // the entries are written before they are read, so they need no initialization
+    std::unique_ptr<radix::Entry<Bits>[]> first(new radix::Entry<Bits>[n]);
+    std::unique_ptr<radix::Entry<Bits>[]> second(new radix::Entry<Bits>[n]);
+    std::vector<radix::Counts<Bits>> counts(threads);
+    radix::forSlices(n, threads, [&](size_t t, size_t begin, size_t end) {
+        radix::decodeKeys<Bits, Signed>(tokens, begin, end, first.get(), counts[t]);
+    });
+    for (size_t t = 1; t < threads; ++t) {
+        for (size_t pass = 0; pass < counts[0].size(); ++pass) {
+            for (size_t digit = 0; digit < 256; ++digit) {
+                counts[0][pass][digit] += counts[t][pass][digit];
+            }
+        }
+    }
+    auto entries = first.get();
+    auto buffer = second.get();
+    radix::sortEntries<Bits>(entries, buffer, n, counts[0], threads);
+
+    std::vector<size_t> res;
+    res.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!unique || i == 0 || entries[i].key != entries[i - 1].key) {
+            res.push_back(entries[i].index);
+        }
+    }
+    return res;
+}
+
+/**
+ * Sorts valid encodings of Bits bits by their values, see sortEncodedIndex().
+ *
+ * @tparam Signed whether to order by the values as signed integers of the width, like
+ * compare64() does, or as unsigned ones
+ * @param tokens the encodings, e.g., std::string or std::string_view, receives them in order
+ * @param unique whether to keep the first token of equal values only
+ * @param threads the number of threads, or 0 for all cores from radix::PARALLEL inputs on
+ */
+template <size_t Bits, bool Signed, typename T>
+void sortEncoded(std::vector<T> &tokens, bool unique = false, size_t threads = 0) {
+    auto order = sortEncodedIndex<Bits, Signed>(tokens, unique, threads);
+    std::vector<T> res;
+    res.reserve(order.size());
+    for (auto i : order) {
+        res.push_back(std::move(tokens[i]));
+    }
+    tokens.swap(res);
+}
+
+} // namespace san
+
+#endif // LIBSAN_SAN_SORT_H
@@ -0,0 +1,1039 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <kernel.h>
+#include <san.h>
+#include <swar.h>
+#include <tables.h>
+#include <x86.h>
+
+using namespace std;
+
+namespace san {
+namespace SAN_KERNEL {
+
+namespace {
+
+using int128_t = __int128;
+using uint128_t = unsigned __int128;
+
+using rules::encodedLength;
+using rules::significantBits;
+
+/**
+ * Writes the characters of all blocks of the input, the most significant one first.
+ * With BMI2 and SSSE3, we spread the blocks over the bytes of a vector and map them all at
+ * once (see x86.h), writing up to 32 characters, else we look up one block (or two blocks,
+ * with SAN_TABLES_PAIR) at a time.
+ *
+ * @param out receives the maxLength(Bits) characters, followed by up to 16 bytes of garbage
+ * @param input the value, sign-extended from its bit size to the full type
+ */
+template <size_t Bits, typename T> void writeBlocks(char *out, T input) {
+    constexpr size_t size = maxLength(Bits);
+#ifdef SAN_X86
+    auto low = x86::spread(static_cast<uint64_t>(input), static_cast<uint64_t>(input >> 48));
+    if constexpr (size > 16) {
+        // the (up to 8) most significant blocks first, then the other 16 overwrite the rest
+        auto high = x86::spread(static_cast<uint64_t>(input >> 96), 0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                         x86::toChars(x86::reverse(high, size - 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + size - 16),
+                         x86::toChars(x86::reverse(low, 16)));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), x86::toChars(x86::reverse(low, size)));
+    }
+#elif defined(SAN_TABLES_PAIR)
+    // an odd leading block on its own, then two blocks per lookup
+    size_t i = size % 2;
+    if (i) {
+        out[0] = enc[input >> 6 * (size - 1) & ONES];
+    }
+    for (; i < size; i += 2) {
+        memcpy(out + i, &encPairs[2 * static_cast<size_t>(input >> 6 * (size - 2 - i) & 0xfff)], 2);
+    }
+#else
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = enc[input >> 6 * (size - 1 - i) & ONES];
+    }
+#endif
+}
+
+/**
+ * Copies 1 to 32 characters with two overlapping fixed-size copies, so the compiler emits a few
+ * unaligned loads and stores instead of a call to memcpy, and nothing behind out + n is written.
+ */
+inline void copyShort(char *out, const char *in, size_t n) {
+    if (n >= 16) {
+        memcpy(out, in, 16);
+        memcpy(out + n - 16, in + n - 16, 16);
+    } else if (n >= 8) {
+        memcpy(out, in, 8);
+        memcpy(out + n - 8, in + n - 8, 8);
+    } else if (n >= 4) {
+        memcpy(out, in, 4);
+        memcpy(out + n - 4, in + n - 4, 4);
+    } else {
+        out[0] = in[0];
+        out[n / 2] = in[n / 2];
+        out[n - 1] = in[n - 1];
+    }
+}
+
+/**
+ * Encodes all blocks of the input and copies the shortest encoding into the output buffer.
+ * Like std::to_chars, only the characters of the encoding are written.
+ *
+ * @param first start of the output buffer
+ * @param last end of the output buffer
+ * @param input the value, sign-extended from its bit size to the full type
+ * @return the end of the written encoding, or ERROR::NO_SPACE
+ */
+template <size_t Bits, typename T> to_chars_result encodeBlocks(char *first, char *last, T input) {
+    constexpr size_t size = maxLength(Bits);
+    static_assert(size <= 32, "copyShort() takes at most 32 characters");
+    // writeBlocks() may write up to 16 bytes behind the blocks
+    array<char, size + 16 < 32 ? 32 : size + 16> blocks{};
+    writeBlocks<Bits>(blocks.data(), input);
+    auto length = encodedLength<Bits>(input);
+    if (static_cast<size_t>(last - first) < length) {
+        return {last, ERROR::NO_SPACE};
+    }
+    copyShort(first, blocks.data() + size - length, length);
+    return {first + length, ERROR::OK};
+}
+
+/**
+ * Sign-extends the lowest Bits bits of the input to the full 64 bits.
+ */
+template <size_t Bits> int64_t extend(int64_t input) {
+    return static_cast<int64_t>(static_cast<uint64_t>(input) << (64 - Bits)) >> (64 - Bits);
+}
+
+/**
+ * Joins the most and least significant 8 bytes of a 16-byte value.
+ */
+inline int128_t join(int64_t ab, int64_t cd) {
+    return static_cast<int128_t>(static_cast<uint128_t>(static_cast<uint64_t>(ab)) << 64 |
+                                 static_cast<uint64_t>(cd));
+}
+
+/**
+ * Encodes the values [i, n) of a batch one at a time, behind the first pos characters.
+ *
+ * @param toInput converts a value into the sign-extended input of encodeBlocks()
+ * @return the end of the written encodings
+ */
+template <size_t Bits, typename T, typename Input>
+char *encodeEach(const T *in, size_t i, size_t n, char *out, size_t pos, uint32_t *offsets,
+                 Input &&toInput) {
+    auto last = out + n * maxLength(Bits);
+    for (; i < n; ++i) {
+        offsets[i] = static_cast<uint32_t>(pos);
+        pos = static_cast<size_t>(encodeBlocks<Bits>(out + pos, last, toInput(in[i])).ptr - out);
+    }
+    offsets[n] = static_cast<uint32_t>(pos);
+    return out + pos;
+}
+
+#ifdef SAN_X86_AVX2
+/**
+ * Encodes four values of up to 8 characters per iteration: each 64-bit lane of a vector
+ * holds the blocks of one value, reversed by its length, so the encoding starts at its
+ * first byte. We store the lanes one behind the other, each store overwriting the garbage
+ * behind the previous encoding, as long as the output has room for the last store.
+ *
+ * @param pos receives the end of the written encodings
+ * @return the number of encoded values
+ */
+template <size_t Bits, typename T, typename Input>
+size_t encodeLanes8(const T *in, size_t n, char *out, size_t &pos, uint32_t *offsets,
+                    Input &&toInput) {
+    constexpr size_t size = maxLength(Bits);
+    static_assert(size <= 8, "the blocks of a value must fit into 8 bytes");
+    const auto indices = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1,
+                                          2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7);
+    size_t i = 0;
+    for (; i + 4 <= n && (n - i - 3) * size >= 8; i += 4) {
+        uint64_t blocks[4];
+        size_t lengths[4];
+        for (size_t k = 0; k < 4; ++k) {
+            auto input = toInput(in[i + k]);
+            blocks[k] = _pdep_u64(static_cast<uint64_t>(input), x86::BLOCKS);
+            lengths[k] = encodedLength<Bits>(input);
+        }
+        // the last block is at length - 1 within the lane, i.e., 8 more for the odd lanes
+        auto lasts = _mm256_setr_epi64x(
+            static_cast<int64_t>((lengths[0] - 1) * swar::LOW),
+            static_cast<int64_t>((lengths[1] + 7) * swar::LOW),
+            static_cast<int64_t>((lengths[2] - 1) * swar::LOW),
+            static_cast<int64_t>((lengths[3] + 7) * swar::LOW));
+        auto spread = _mm256_setr_epi64x(
+            static_cast<int64_t>(blocks[0]), static_cast<int64_t>(blocks[1]),
+            static_cast<int64_t>(blocks[2]), static_cast<int64_t>(blocks[3]));
+        auto chars = x86::toChars(_mm256_shuffle_epi8(spread, _mm256_sub_epi8(lasts, indices)));
+        auto halves = {_mm256_castsi256_si128(chars), _mm256_extracti128_si256(chars, 1)};
+        size_t k = i;
+        for (auto half : halves) {
+            offsets[k] = static_cast<uint32_t>(pos);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out + pos), half);
+            pos += lengths[k++ - i];
+            offsets[k] = static_cast<uint32_t>(pos);
+            _mm_storeh_pd(reinterpret_cast<double *>(out + pos), _mm_castsi128_pd(half));
+            pos += lengths[k++ - i];
+        }
+    }
+    return i;
+}
+
+/**
+ * Encodes two values of up to 16 characters per iteration, see encodeLanes8(), with one
+ * value per 128-bit half.
+ *
+ * @param pos receives the end of the written encodings
+ * @return the number of encoded values
+ */
+template <size_t Bits, typename T, typename Input>
+size_t encodeLanes16(const T *in, size_t n, char *out, size_t &pos, uint32_t *offsets,
+                     Input &&toInput) {
+    constexpr size_t size = maxLength(Bits);
+    static_assert(size <= 16, "the blocks of a value must fit into 16 bytes");
+    const auto indices = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                          0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    size_t i = 0;
+    for (; i + 2 <= n && (n - i - 1) * size >= 16; i += 2) {
+        auto first = toInput(in[i]);
+        auto second = toInput(in[i + 1]);
+        auto firstLength = encodedLength<Bits>(first);
+        auto secondLength = encodedLength<Bits>(second);
+        auto spread = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(x86::spread(static_cast<uint64_t>(first),
+                                               static_cast<uint64_t>(first >> 48))),
+            x86::spread(static_cast<uint64_t>(second), static_cast<uint64_t>(second >> 48)), 1);
+        auto lasts = _mm256_setr_epi64x(static_cast<int64_t>((firstLength - 1) * swar::LOW),
+                                        static_cast<int64_t>((firstLength - 1) * swar::LOW),
+                                        static_cast<int64_t>((secondLength - 1) * swar::LOW),
+                                        static_cast<int64_t>((secondLength - 1) * swar::LOW));
+        auto chars = x86::toChars(_mm256_shuffle_epi8(spread, _mm256_sub_epi8(lasts, indices)));
+        offsets[i] = static_cast<uint32_t>(pos);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos), _mm256_castsi256_si128(chars));
+        pos += firstLength;
+        offsets[i + 1] = static_cast<uint32_t>(pos);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos),
+                         _mm256_extracti128_si256(chars, 1));
+        pos += secondLength;
+    }
+    return i;
+}
+#endif
+
+#ifdef SAN_X86
+/**
+ * Encodes 16-byte values one at a time, like encodeBlocks() but without the detour through
+ * a temporary array: the up to 6 most significant blocks, reversed by their count, go
+ * first, then the other 16, which overwrite the garbage behind them. All stores end within
+ * the maxLength(128) characters, which each value has room for.
+ *
+ * @return the end of the written encodings
+ */
+char *encodeEach128(const pair<int64_t, int64_t> *in, size_t n, char *out, uint32_t *offsets) {
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto input = join(in[i].first, in[i].second);
+        auto length = encodedLength<128>(input);
+        auto low = x86::spread(static_cast<uint64_t>(input), static_cast<uint64_t>(input >> 48));
+        offsets[i] = static_cast<uint32_t>(pos);
+        if (length > 16) {
+            auto high = x86::spread(static_cast<uint64_t>(input >> 96), 0);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos),
+                             x86::toChars(x86::reverse(high, static_cast<int>(length - 16))));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos + length - 16),
+                             x86::toChars(x86::reverse(low, 16)));
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos),
+                             x86::toChars(x86::reverse(low, static_cast<int>(length))));
+        }
+        pos += length;
+    }
+    offsets[n] = static_cast<uint32_t>(pos);
+    return out + pos;
+}
+#endif
+
+/**
+ * Determines the leading fill of the decoded value, i.e., all 1s for a leading
+ * 1s block and all 0s otherwise (including empty input).
+ */
+template <typename T> T fill(const char *first, const char *last) {
+    return first != last && *first == enc[ONES] ? ~T{0} : T{0};
+}
+
+/**
+ * Decodes the input by shifting its blocks into the result, which holds the fill initially.
+ * If the input is checked, decoding stops at the first invalid character.
+ *
+ * By default, this looks up each character in the decode table. With SAN_DECODER_SWAR,
+ * it maps up to 8 characters at a time with arithmetic instead (see swar.h), which only
+ * pays off for long inputs on most CPUs, so it is opt-in. With BMI2 and SSSE3, it maps
+ * up to 16 characters at a time in a vector (see x86.h). With SAN_TABLES_PAIR, the table
+ * lookups take two characters at a time.
+ *
+ * @param first start of the non-empty input
+ * @param size number of characters
+ * @param res the leading fill, receives the decoded value
+ * @return the index of the first invalid character, or size if all are valid (or unchecked)
+ */
+template <bool Checked, typename T> size_t decodeBlocks(const char *first, size_t size, T &res) {
+#ifdef SAN_DECODER_SWAR
+    // the head takes the leftover characters, so all other words are complete
+    size_t head = (size - 1) % 8 + 1;
+    uint64_t blocks;
+    auto invalid = swar::decode(first, head, blocks);
+    if (Checked && invalid) {
+        return swar::firstInvalid(invalid, head);
+    }
+    res = res << 6 * head | blocks;
+    for (size_t pos = head; pos < size; pos += 8) {
+        invalid = swar::decode(first + pos, blocks);
+        if (Checked && invalid) {
+            return pos + swar::firstInvalid(invalid, 8);
+        }
+        res = res << 48 | blocks;
+    }
+#elif defined(SAN_X86)
+    // 16 characters at a time, again with the leftover ones first
+    for (size_t pos = 0, n = (size - 1) % 16 + 1; pos < size; pos += n, n = 16) {
+        __m128i blocks;
+        auto count = static_cast<int>(n);
+        auto invalid = x86::toBlocks(x86::loadRight(first + pos + n, n), blocks) >> (16 - n);
+        if (Checked && invalid) {
+            return pos + __builtin_ctz(invalid);
+        }
+        auto packed = x86::pack(blocks, 16, count);
+        res = static_cast<T>(static_cast<uint128_t>(res) << 6 * n | packed);
+    }
+#else
+    size_t pos = 0;
+#ifdef SAN_TABLES_PAIR
+    for (; pos + 1 < size; pos += 2) {
+        auto pair = decPairs[(first[pos] & 0x7f) << 7 | (first[pos + 1] & 0x7f)];
+        if (Checked && ((first[pos] | first[pos + 1]) & 0x80 || pair >= 4096)) {
+            break; // the single characters below tell which one is invalid
+        }
+        res = (res << 12) + pair;
+    }
+#endif
+    for (; pos < size; ++pos) {
+        auto byte = static_cast<uint8_t>(first[pos]);
+        auto block = static_cast<uint8_t>(dec[byte & 0x7f]);
+        if (Checked && (byte >= 128 || block >= 64)) {
+            return pos;
+        }
+        res = (res << 6) + block;
+    }
+#endif
+    return size;
+}
+
+/**
+ * Checks the length of valid characters, see rules::checkLength().
+ */
+inline from_chars_result checkLength(const char *first, size_t size, size_t bitSize) {
+    return rules::checkLength(first, size, bitSize, dec);
+}
+
+/**
+ * Decodes the input while validating it like valid() does, so untrusted
+ * input needs a single pass only.
+ *
+ * @param first start of the encoded input
+ * @param last end of the encoded input
+ * @param bitSize length of the originally encoded input, or 0 to skip the length checks
+ * @param res receives the decoded value
+ * @return the end of the input, or the error and its position
+ */
+template <typename T>
+from_chars_result decodeChecked(const char *first, const char *last, size_t bitSize, T &res) {
+    if (first == last) {
+        return {first, ERROR::EMPTY};
+    }
+
+    res = fill<T>(first, last);
+    auto size = static_cast<size_t>(last - first);
+    auto pos = decodeBlocks<true>(first, size, res);
+    if (pos != size) {
+        auto byte = static_cast<uint8_t>(first[pos]);
+        return {first + pos, byte >= 128 ? ERROR::HIGH_BIT : ERROR::WRONG_CHAR};
+    }
+
+    return bitSize ? checkLength(first, size, bitSize) : from_chars_result{last, ERROR::OK};
+}
+
+/**
+ * Decodes the input without validating it.
+ *
+ * @param input the encoded input, which may be empty
+ * @return the decoded value
+ */
+template <typename T> T decodeUnchecked(string_view input) {
+    auto res = fill<T>(input.data(), input.data() + input.size());
+    if (!input.empty()) {
+        decodeBlocks<false>(input.data(), input.size(), res);
+    }
+    return res;
+}
+
+/**
+ * Decodes the token at the start of the input, up to the next delimiter or the end.
+ *
+ * @param first start of the token
+ * @param last end of the input
+ * @param value receives the decoded value
+ * @return the end of the token, or the error and its position
+ */
+template <size_t Bits>
+from_chars_result decodeToken(const char *first, const char *last, char delimiter,
+                              uint128_t &value) {
+    auto end = static_cast<const char *>(memchr(first, delimiter, last - first));
+    typename conditional<Bits <= 64, uint64_t, uint128_t>::type res;
+    auto result = decodeChecked(first, end ? end : last, Bits, res);
+    value = res;
+    return result;
+}
+
+/**
+ * Decodes the delimiter-separated tokens of a buffer, see decodeBatch32().
+ *
+ * With BMI2 and SSSE3, we look at 16 characters at a time: comparing them with the
+ * delimiter tells where the tokens in them end, and one toBlocks() call maps and validates
+ * all of them, so the tokens just need to be packed from the vector. A token, which does
+ * not end within the 16 characters from its start, is decoded on its own.
+ *
+ * @param store called with the index and the value of every decoded token
+ */
+template <size_t Bits, typename Store>
+decode_batch_result decodeTokens(const char *buffer, size_t length, char delimiter,
+                                 Store &&store) {
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < length) {
+        auto first = buffer + pos;
+#ifdef SAN_X86
+        auto available = length - pos;
+        __m128i chars;
+        uint32_t ends;
+        if (available >= 16) {
+            chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+            ends = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(delimiter)));
+        } else {
+            alignas(16) char rest[16] = {};
+            memcpy(rest, first, available);
+            chars = _mm_load_si128(reinterpret_cast<const __m128i *>(rest));
+            ends = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(delimiter)));
+            // the end of the buffer ends the last token, too
+            ends = (ends & ((1u << available) - 1)) | 1u << available;
+        }
+        if (ends) {
+            __m128i blocks;
+            auto invalid = x86::toBlocks(chars, blocks);
+            uint32_t start = 0;
+            for (; ends; ends &= ends - 1) {
+                auto end = static_cast<uint32_t>(__builtin_ctz(ends));
+                auto size = end - start;
+                auto token = first + start;
+                if (!size) {
+                    if (start == available) {
+                        break; // a trailing delimiter
+                    }
+                    return {token, ERROR::EMPTY, count};
+                }
+                if (auto wrong = invalid >> start & ((1u << size) - 1)) {
+                    auto at = token + __builtin_ctz(wrong);
+                    auto high = static_cast<uint8_t>(*at) >= 128;
+                    return {at, high ? ERROR::HIGH_BIT : ERROR::WRONG_CHAR, count};
+                }
+                auto result = checkLength(token, size, Bits);
+                if (result.ec != ERROR::OK) {
+                    return {result.ptr, result.ec, count};
+                }
+                auto value = x86::pack(blocks, static_cast<int>(end), static_cast<int>(size));
+                // the fill, without a branch on the (random) sign
+                auto negative = static_cast<uint64_t>(*token == enc[ONES]);
+                store(count++, value | -static_cast<uint128_t>(negative) << 6 * size);
+                start = end + 1;
+            }
+            pos += start;
+            continue;
+        }
+#endif
+        uint128_t value;
+        auto result = decodeToken<Bits>(first, buffer + length, delimiter, value);
+        if (result.ec != ERROR::OK) {
+            return {result.ptr, result.ec, count};
+        }
+        store(count++, value);
+        pos = static_cast<size_t>(result.ptr - buffer) + 1;
+    }
+    return {buffer + length, ERROR::OK, count};
+}
+
+#ifdef SAN_X86_SSSE3
+/**
+ * Marks where runs of at least `count` (1-63) characters end, which are not delimiters,
+ * i.e., bit i of the result is set if none of the characters i - count + 1 to i is one.
+ * Runs are not continued from before the first character.
+ *
+ * @param tokens a mask of the characters, which are not delimiters
+ */
+inline uint64_t runs(uint64_t tokens, size_t count) {
+    // combine runs of power of two lengths, doubling their length in each step
+    auto res = ~uint64_t{0};
+    size_t shift = 0;
+    for (size_t width = 1; count; width *= 2, count >>= 1) {
+        if (count & 1) {
+            res &= tokens << shift;
+            shift += width;
+        }
+        tokens &= tokens << width;
+    }
+    return res;
+}
+
+/**
+ * A set of the characters, which are no valid top block of a full-length encoding of the
+ * given bit size (see checkLength()), as a mask indexed by the character.
+ */
+uint128_t invalidTops(size_t bitSize) {
+    uint128_t res = 0;
+    for (auto c : string_view(enc, 64)) {
+        if (checkLength(&c, maxLength(bitSize), bitSize).ec != ERROR::OK) {
+            res |= uint128_t{1} << c;
+        }
+    }
+    return res;
+}
+
+/**
+ * Skips the valid tokens at the start of the buffer, 64 characters at a time. These are
+ * clean, if they are all valid or delimiters, no delimiter follows another one, there is
+ * no run of more than maxLength(bitSize) characters between delimiters, and those runs of
+ * exactly that length start with a valid top block. Anything else is left to the caller.
+ *
+ * @param pos the start of a token, i.e., the start of the buffer or after a delimiter
+ * @param bitSize length of the originally encoded input, or 0 to skip the length checks
+ * @param count incremented by the number of skipped tokens
+ * @return the start of the first token, which is not known to be valid
+ */
+size_t skipValid(const char *buffer, size_t pos, size_t length, char delimiter, size_t bitSize,
+                 size_t &count) {
+    auto maxSize = bitSize ? maxLength(bitSize) : 0;
+    if (maxSize >= 64 || length - pos < 64) {
+        return pos;
+    }
+    auto set = x86::toSet(bitSize % 6 ? invalidTops(bitSize) : 0);
+    auto start = pos;
+    size_t carry = 0; // the characters of the token, which started in the previous chunks
+    uint64_t previousTops = 0;
+    for (; pos + 64 <= length; pos += 64) {
+        uint64_t delimiters;
+        uint64_t wrongTops;
+        auto bad = x86::classify(buffer + pos, delimiter, set, delimiters, wrongTops);
+        auto tokens = ~delimiters;
+        // an empty token, i.e., a delimiter right after the previous one
+        bad |= delimiters & ~(tokens << 1 | (carry != 0));
+        if (bitSize) {
+            // the token continued from the previous chunk, marked at its end
+            // (without branches, as tokens end at random positions)
+            auto head = static_cast<size_t>(delimiters ? __builtin_ctzll(delimiters) : 64);
+            auto exact = carry && carry + head == maxSize;
+            auto first = previousTops >> ((64 + head - maxSize) & 63) & 1;
+            bad |= carry && carry + head > maxSize ? 1ul << (maxSize - carry) : 0;
+            bad |= exact && first ? 1ul << head : 0;
+
+            // the tokens within the chunk, full-length ones also marked at their end
+            auto full = runs(tokens, maxSize);
+            auto longer = full & tokens << maxSize;
+            bad |= longer | (full & ~longer & delimiters >> 1 & wrongTops << (maxSize - 1));
+        }
+        carry = delimiters ? static_cast<size_t>(__builtin_clzll(delimiters)) : carry + 64;
+        previousTops = wrongTops;
+        if (bad) {
+            // the tokens, which end before the first finding, are still valid
+            auto before = delimiters & ((bad & -bad) - 1);
+            count += static_cast<size_t>(__builtin_popcountll(before));
+            return before ? pos + 64 - __builtin_clzll(before) : start;
+        }
+        count += static_cast<size_t>(__builtin_popcountll(delimiters));
+        if (delimiters) {
+            start = pos + 64 - __builtin_clzll(delimiters);
+        }
+    }
+    return start;
+}
+#endif
+
+/**
+ * Validates the delimiter-separated tokens of a buffer, see validBatch().
+ *
+ * With SSSE3, skipValid() classifies 64 characters at a time and only the tokens
+ * it cannot prove to be valid are checked one by one, like valid() does.
+ *
+ * @param report called with the position and the error of every malformed token, returns
+ *        whether to continue
+ * @return the number of tokens checked, or those before the malformed one if stopped
+ */
+template <typename OnError>
+size_t validateTokens(const char *buffer, size_t length, char delimiter, size_t bitSize,
+                      OnError &&report) {
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < length) {
+#ifdef SAN_X86_SSSE3
+        pos = skipValid(buffer, pos, length, delimiter, bitSize, count);
+        if (pos == length) {
+            break; // a trailing delimiter
+        }
+#endif
+        auto first = buffer + pos;
+        auto end = static_cast<const char *>(memchr(first, delimiter, length - pos));
+        uint64_t res;
+        auto result = decodeChecked(first, end ? end : buffer + length, bitSize, res);
+        if (result.ec != ERROR::OK && !report(result)) {
+            return count;
+        }
+        ++count;
+        pos = end ? static_cast<size_t>(end - buffer) + 1 : length;
+    }
+    return count;
+}
+
+/**
+ * Determines whether a leading block can be omitted, given the following character, i.e.,
+ * a 0s block, which is not followed by a 1s block, or a 1s block, which is. The last block
+ * of a token is never omitted.
+ */
+inline bool redundant(char c, char next, char delimiter) {
+    return next != delimiter && (c == enc[0] ? next != enc[ONES] : c == enc[ONES] && next == c);
+}
+
+#ifdef SAN_X86_SSSE3
+/**
+ * Strips the redundant leading blocks of the tokens, 64 characters at a time. Chunks
+ * without them are only moved, if an earlier one had some, and otherwise not even written.
+ *
+ * @param out receives the number of characters written
+ * @param leading receives whether the next character starts a token, or follows omitted
+ *        blocks only
+ * @return the number of characters read, i.e., the first one left to the caller
+ */
+size_t stripChunks(char *buffer, size_t length, char delimiter, size_t &out, bool &leading) {
+    size_t pos = 0;
+    for (; pos + 65 <= length; pos += 64) {
+        uint64_t masks[3];
+        x86::find(buffer + pos, {enc[0], enc[ONES], delimiter}, masks);
+        auto [zeros, ones, delimiters] = masks;
+        // the classes of the following characters, including the one after the chunk
+        auto nextOnes = ones >> 1 | static_cast<uint64_t>(buffer[pos + 64] == enc[ONES]) << 63;
+        auto nextEnds = delimiters >> 1 | static_cast<uint64_t>(buffer[pos + 64] == delimiter)
+                                              << 63;
+        auto candidates = ((zeros & ~nextOnes) | (ones & nextOnes)) & ~nextEnds;
+        // the runs of candidates, which start a token, i.e., whose carry clears them
+        auto starts = (delimiters << 1 | leading) & candidates;
+        auto omitted = candidates & ~(candidates + starts);
+        leading = (delimiters | omitted) >> 63;
+
+        if (!omitted) {
+            if (out != pos) {
+                memmove(buffer + out, buffer + pos, 64);
+            }
+            out += 64;
+            continue;
+        }
+#ifdef SAN_X86
+        // pack the kept characters of 8 at a time, which only overwrites characters read
+        for (size_t i = 0; i < 64; i += 8) {
+            uint64_t word;
+            memcpy(&word, buffer + pos + i, 8);
+            auto kept = static_cast<uint8_t>(~omitted >> i);
+            auto packed = _pext_u64(word, _pdep_u64(kept, 0x0101010101010101) * 0xff);
+            memcpy(buffer + out, &packed, 8);
+            out += static_cast<size_t>(__builtin_popcount(kept));
+        }
+#else
+        // move the runs of kept characters
+        for (size_t i = 0; i < 64;) {
+            auto rest = omitted >> i;
+            auto kept = rest ? static_cast<size_t>(__builtin_ctzll(rest)) : 64 - i;
+            memmove(buffer + out, buffer + pos + i, kept);
+            out += kept;
+            i += kept;
+            if (i < 64) {
+                auto remaining = ~omitted >> i;
+                i += remaining ? static_cast<size_t>(__builtin_ctzll(remaining)) : 64 - i;
+            }
+        }
+#endif
+    }
+    return pos;
+}
+#endif
+
+/**
+ * The i-th byte of a byte array, counted from the least significant one, where the bytes
+ * beyond the array are the fill, i.e., the sign extension.
+ */
+inline uint8_t byteAt(const uint8_t *in, size_t n, ENDIAN order, size_t i, uint8_t fill) {
+    return i >= n ? fill : order == ENDIAN::BIG ? in[n - 1 - i] : in[i];
+}
+
+/**
+ * The 48 bits of a byte array from the given byte on, i.e., 8 blocks, sign-extended
+ * beyond the array.
+ */
+inline uint64_t wordAt(const uint8_t *in, size_t n, ENDIAN order, size_t i, uint8_t fill) {
+    uint64_t res = 0;
+    if (i + 8 <= n) {
+        // within the array, one load (and a byte swap)
+        memcpy(&res, order == ENDIAN::BIG ? in + n - i - 8 : in + i, 8);
+        return (order == ENDIAN::BIG ? __builtin_bswap64(res) : res) & ((1ul << 48) - 1);
+    }
+    for (size_t byte = 0; byte < 6; ++byte) {
+        res |= uint64_t{byteAt(in, n, order, i + byte, fill)} << 8 * byte;
+    }
+    return res;
+}
+
+/**
+ * The fill of a byte array, i.e., 0xff for a negative most significant byte, else 0.
+ */
+inline uint8_t bytesFill(const uint8_t *in, size_t n, ENDIAN order) {
+    return static_cast<uint8_t>(-(byteAt(in, n, order, n - 1, 0) >> 7));
+}
+
+/**
+ * Computes the length like encodedLength() does, but skips the leading fill bytes first.
+ */
+size_t bytesLength(const uint8_t *in, size_t n, ENDIAN order) {
+    auto fill = bytesFill(in, n, order);
+    auto top = n;
+    while (top > 1 && byteAt(in, n, order, top - 1, fill) == fill) {
+        --top;
+    }
+    auto bits = 8 * (top - 1) + significantBits(uint64_t{byteAt(in, n, order, top - 1, 0)} ^
+                                                 fill);
+    auto length = (bits + 5) / 6;
+    auto offset = 6 * (length - 1);
+    auto word = byteAt(in, n, order, offset / 8, fill) |
+                byteAt(in, n, order, offset / 8 + 1, fill) << 8;
+    length += ((word >> offset % 8 & ONES) == ONES) != (fill != 0);
+    return length < maxLength(8 * n) ? length : maxLength(8 * n);
+}
+
+// the entry points, see san.h
+
+ERROR valid(const char *first, const char *last, size_t bitSize) {
+    uint64_t res;
+    return decodeChecked(first, last, bitSize, res).ec;
+}
+
+size_t validBatch(const char *buffer, size_t length, char delimiter, size_t bitSize,
+                  Report report, void *context) {
+    return validateTokens(buffer, length, delimiter, bitSize,
+                          [report, context](from_chars_result error) {
+                              return report(context, error);
+                          });
+}
+
+to_chars_result encode24Signed(char *first, char *last, int32_t input) {
+    return encodeBlocks<24>(first, last, extend<24>(input));
+}
+
+to_chars_result encode32Signed(char *first, char *last, int32_t input) {
+    return encodeBlocks<32>(first, last, static_cast<int64_t>(input));
+}
+
+to_chars_result encode48Signed(char *first, char *last, int64_t input) {
+    return encodeBlocks<48>(first, last, extend<48>(input));
+}
+
+to_chars_result encode64Signed(char *first, char *last, int64_t input) {
+    return encodeBlocks<64>(first, last, input);
+}
+
+to_chars_result encode128Signed(char *first, char *last, int128_t input) {
+    return encodeBlocks<128>(first, last, input);
+}
+
+char *encodeBatch32(const int32_t *in, size_t n, char *out, uint32_t *offsets) {
+    auto toInput = [](int32_t input) { return static_cast<int64_t>(input); };
+    size_t i = 0, pos = 0;
+#ifdef SAN_X86_AVX2
+    i = encodeLanes8<32>(in, n, out, pos, offsets, toInput);
+#endif
+    return encodeEach<32>(in, i, n, out, pos, offsets, toInput);
+}
+
+char *encodeBatch48(const int64_t *in, size_t n, char *out, uint32_t *offsets) {
+    size_t i = 0, pos = 0;
+#ifdef SAN_X86_AVX2
+    i = encodeLanes8<48>(in, n, out, pos, offsets, extend<48>);
+#endif
+    return encodeEach<48>(in, i, n, out, pos, offsets, extend<48>);
+}
+
+char *encodeBatch64(const int64_t *in, size_t n, char *out, uint32_t *offsets) {
+    auto toInput = [](int64_t input) { return input; };
+    size_t i = 0, pos = 0;
+#ifdef SAN_X86_AVX2
+    i = encodeLanes16<64>(in, n, out, pos, offsets, toInput);
+#endif
+    return encodeEach<64>(in, i, n, out, pos, offsets, toInput);
+}
+
+char *encodeBatch128(const pair<int64_t, int64_t> *in, size_t n, char *out, uint32_t *offsets) {
+#ifdef SAN_X86
+    return encodeEach128(in, n, out, offsets);
+#else
+    auto toInput = [](const pair<int64_t, int64_t> &input) {
+        return join(input.first, input.second);
+    };
+    return encodeEach<128>(in, 0, n, out, 0, offsets, toInput);
+#endif
+}
+
+uint32_t decode24(string_view input) { return decode32(input) & (1u << 24) - 1; }
+
+from_chars_result decode24(const char *first, const char *last, uint32_t &output) {
+    uint64_t res;
+    auto result = decodeChecked(first, last, 24, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<uint32_t>(res) & (1u << 24) - 1;
+    }
+    return result;
+}
+
+uint32_t decode32(string_view input) {
+    return static_cast<uint32_t>(decodeUnchecked<uint64_t>(input));
+}
+
+from_chars_result decode32(const char *first, const char *last, uint32_t &output) {
+    uint64_t res;
+    auto result = decodeChecked(first, last, 32, res);
+    if (result.ec == ERROR::OK) {
+        output = static_cast<uint32_t>(res);
+    }
+    return result;
+}
+
+uint64_t decode48(string_view input) { return decode64(input) & (1ul << 48) - 1; }
+
+from_chars_result decode48(const char *first, const char *last, uint64_t &output) {
+    uint64_t res;
+    auto result = decodeChecked(first, last, 48, res);
+    if (result.ec == ERROR::OK) {
+        output = res & (1ul << 48) - 1;
+    }
+    return result;
+}
+
+uint64_t decode64(string_view input) { return decodeUnchecked<uint64_t>(input); }
+
+from_chars_result decode64(const char *first, const char *last, uint64_t &output) {
+    uint64_t res;
+    auto result = decodeChecked(first, last, 64, res);
+    if (result.ec == ERROR::OK) {
+        output = res;
+    }
+    return result;
+}
+
+uint128_t decode128(string_view input) { return decodeUnchecked<uint128_t>(input); }
+
+from_chars_result decode128(const char *first, const char *last, uint128_t &output) {
+    uint128_t res;
+    auto result = decodeChecked(first, last, 128, res);
+    if (result.ec == ERROR::OK) {
+        output = res;
+    }
+    return result;
+}
+
+decode_batch_result decodeBatch32(const char *buffer, size_t length, char delimiter,
+                                  uint32_t *out) {
+    return decodeTokens<32>(buffer, length, delimiter, [out](size_t i, uint128_t value) {
+        out[i] = static_cast<uint32_t>(value);
+    });
+}
+
+decode_batch_result decodeBatch48(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out) {
+    return decodeTokens<48>(buffer, length, delimiter, [out](size_t i, uint128_t value) {
+        out[i] = static_cast<uint64_t>(value) & (1ul << 48) - 1;
+    });
+}
+
+decode_batch_result decodeBatch64(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out) {
+    return decodeTokens<64>(buffer, length, delimiter, [out](size_t i, uint128_t value) {
+        out[i] = static_cast<uint64_t>(value);
+    });
+}
+
+decode_batch_result decodeBatch128(const char *buffer, size_t length, char delimiter,
+                                   pair<uint64_t, uint64_t> *out) {
+    return decodeTokens<128>(buffer, length, delimiter, [out](size_t i, uint128_t value) {
+        out[i] = {static_cast<uint64_t>(value >> 64), static_cast<uint64_t>(value)};
+    });
+}
+
+size_t encodeBytesLength(const uint8_t *in, size_t n, ENDIAN order) {
+    return bytesLength(in, n, order);
+}
+
+/**
+ * Writes 8 blocks, i.e., 6 bytes, at a time from the least significant ones on, with the
+ * x86 kernels mapped in a vector, like the 48 bit values of encodeBlocks().
+ */
+char *encodeBytes(const uint8_t *in, size_t n, char *out, ENDIAN order) {
+    auto fill = bytesFill(in, n, order);
+    auto length = bytesLength(in, n, order);
+    array<char, 32> blocks;
+    for (size_t end = length, byte = 0; end; byte += 6) {
+        writeBlocks<48>(blocks.data(), wordAt(in, n, order, byte, fill));
+        if (end >= 8) {
+            memcpy(out + end - 8, blocks.data(), 8);
+            end -= 8;
+        } else {
+            memcpy(out, blocks.data() + 8 - end, end);
+            end = 0;
+        }
+    }
+    return out + length;
+}
+
+/**
+ * Validates the input like valid(), then decodes 8 blocks, i.e., 6 bytes, at a time from
+ * the least significant ones on, and sign-extends the rest.
+ */
+from_chars_result decodeBytes(const char *first, const char *last, uint8_t *out, size_t n,
+                              ENDIAN order) {
+    uint64_t ignored;
+    auto result = decodeChecked(first, last, 8 * n, ignored);
+    if (result.ec != ERROR::OK) {
+        return result;
+    }
+    auto size = static_cast<size_t>(last - first);
+    auto sign = static_cast<uint8_t>(fill<uint64_t>(first, last));
+    size_t byte = 0;
+    for (size_t end = size; end; end = end >= 8 ? end - 8 : 0) {
+        auto start = end >= 8 ? end - 8 : 0;
+        auto word = start ? uint64_t{0} : fill<uint64_t>(first, last);
+        decodeBlocks<false>(first + start, end - start, word);
+        for (size_t i = 0; i < 6 && byte < n; ++i, ++byte) {
+            out[order == ENDIAN::BIG ? n - 1 - byte : byte] = static_cast<uint8_t>(word >> 8 * i);
+        }
+    }
+    for (; byte < n; ++byte) {
+        out[order == ENDIAN::BIG ? n - 1 - byte : byte] = sign;
+    }
+    return result;
+}
+
+/**
+ * Determines the sign of a valid encoding, i.e., a leading '-', or the sign bit of the first
+ * block of a full-length one (e.g., "0+++++" is negative for 32 bit, "W+++" for 24 bit).
+ */
+inline bool isNegative(string_view input, size_t bitSize) {
+    if (input.empty()) {
+        return false;
+    }
+    auto top = static_cast<uint8_t>(dec[static_cast<uint8_t>(input[0]) & 0x7f]);
+    return input.size() < maxLength(bitSize) ? top == ONES : top >> (bitSize - 1) % 6 & 1;
+}
+
+/**
+ * The index of the first character, in which two inputs of the same size differ, or the
+ * size if they are equal. With SSSE3, this compares 16 characters at a time, again with
+ * the leftover ones first.
+ */
+inline size_t mismatch(const char *a, const char *b, size_t size) {
+#ifdef SAN_X86_SSSE3
+    for (size_t pos = 0, n = (size - 1) % 16 + 1; pos < size; pos += n, n = 16) {
+        auto equal = _mm_cmpeq_epi8(x86::loadRight(a + pos + n, n), x86::loadRight(b + pos + n, n));
+        auto differ = (~static_cast<uint32_t>(_mm_movemask_epi8(equal)) & 0xffff) >> (16 - n);
+        if (differ) {
+            return pos + __builtin_ctz(differ);
+        }
+    }
+    return size;
+#else
+    return static_cast<size_t>(std::mismatch(a, a + size, b).first - a);
+#endif
+}
+
+/**
+ * Compares valid encodings by their values as signed integers of the given bit size. The
+ * blocks after the leading fill of the sign are the two's complement of the value, so more
+ * of them mean a larger positive, but a smaller negative value, and otherwise the first
+ * different block decides.
+ */
+int compare(string_view a, string_view b, size_t bitSize) {
+    auto negative = isNegative(a, bitSize);
+    if (negative != isNegative(b, bitSize)) {
+        return negative ? -1 : 1;
+    }
+    auto sign = enc[negative ? ONES : 0];
+    a.remove_prefix(std::min(a.find_first_not_of(sign), a.size()));
+    b.remove_prefix(std::min(b.find_first_not_of(sign), b.size()));
+    if (a.size() != b.size()) {
+        return (a.size() < b.size()) != negative ? -1 : 1;
+    }
+    auto pos = mismatch(a.data(), b.data(), a.size());
+    if (pos == a.size()) {
+        return 0;
+    }
+    return dec[static_cast<uint8_t>(a[pos]) & 0x7f] < dec[static_cast<uint8_t>(b[pos]) & 0x7f]
+               ? -1
+               : 1;
+}
+
+/**
+ * Strips the redundant leading blocks of the delimiter-separated tokens of a buffer, see
+ * canonicalizeBatch(). With SSSE3, stripChunks() takes 64 characters at a time, and only
+ * the last ones are left to the loop.
+ */
+size_t canonicalizeBatch(char *buffer, size_t length, char delimiter) {
+    size_t out = 0;
+    bool leading = true;
+    size_t pos = 0;
+#ifdef SAN_X86_SSSE3
+    pos = stripChunks(buffer, length, delimiter, out, leading);
+#endif
+    for (; pos < length; ++pos) {
+        auto c = buffer[pos];
+        if (leading && pos + 1 < length && redundant(c, buffer[pos + 1], delimiter)) {
+            continue;
+        }
+        leading = c == delimiter;
+        buffer[out++] = c;
+    }
+    return out;
+}
+
+} // namespace
+
+#define SAN_STRING(name) #name
+#define SAN_NAME(name) SAN_STRING(name)
+
+const Kernel kernel = {SAN_NAME(SAN_KERNEL), valid,          validBatch,     encode24Signed,
+                       encode32Signed,        encode48Signed, encode64Signed, encode128Signed,
+                       encodeBatch32,         encodeBatch48,  encodeBatch64,  encodeBatch128,
+                       decode24,              decode24,       decode32,       decode32,
+                       decode48,              decode48,       decode64,       decode64,
+                       decode128,             decode128,      decodeBatch32,  decodeBatch48,
+                       decodeBatch64,         decodeBatch128, encodeBytesLength,
+                       encodeBytes,           decodeBytes,    compare,
+                       canonicalizeBatch};
+
+} // namespace SAN_KERNEL
+} // namespace san
@@ -0,0 +1,101 @@
+#ifndef SAN_KERNEL_H
+#define SAN_KERNEL_H
+
+#include <san.h>
+
+// The library builds kernel.cpp once per instruction set (see CMakeLists.txt), each time
+// with SAN_KERNEL set to the name of the kernel, which is also the namespace of everything
+// compiled for it: inline functions of different kernels must not be merged by the linker.
+// Outside the library, e.g., in tests, the helpers are compiled for the includer's flags.
+#ifndef SAN_KERNEL
+#define SAN_KERNEL local
+#endif
+
+namespace san {
+
+/**
+ * Called for every malformed token while validating a buffer, see validBatch().
+ *
+ * @param context the context passed along with the callback
+ * @param error the position and the error of the malformed token
+ * @return whether to continue with the next token
+ */
+using Report = bool (*)(void *context, from_chars_result error);
+
+/**
+ * The entry points of a kernel, which the public functions dispatch to. They are those
+ * of san.h, except that validation takes a range and reports errors via a callback, and
+ * that single 128 bit values are native ones, which the pair overloads join and split.
+ */
+struct Kernel {
+    const char *name;
+
+    ERROR (*valid)(const char *first, const char *last, size_t bitSize);
+    size_t (*validBatch)(const char *buffer, size_t length, char delimiter, size_t bitSize,
+                         Report report, void *context);
+
+    to_chars_result (*encode24Signed)(char *first, char *last, int32_t input);
+    to_chars_result (*encode32Signed)(char *first, char *last, int32_t input);
+    to_chars_result (*encode48Signed)(char *first, char *last, int64_t input);
+    to_chars_result (*encode64Signed)(char *first, char *last, int64_t input);
+    to_chars_result (*encode128Signed)(char *first, char *last, __int128 input);
+
+    char *(*encodeBatch32)(const int32_t *in, size_t n, char *out, uint32_t *offsets);
+    char *(*encodeBatch48)(const int64_t *in, size_t n, char *out, uint32_t *offsets);
+    char *(*encodeBatch64)(const int64_t *in, size_t n, char *out, uint32_t *offsets);
+    char *(*encodeBatch128)(const std::pair<int64_t, int64_t> *in, size_t n, char *out,
+                            uint32_t *offsets);
+
+    uint32_t (*decode24)(std::string_view input);
+    from_chars_result (*decode24Checked)(const char *first, const char *last, uint32_t &output);
+    uint32_t (*decode32)(std::string_view input);
+    from_chars_result (*decode32Checked)(const char *first, const char *last, uint32_t &output);
+    uint64_t (*decode48)(std::string_view input);
+    from_chars_result (*decode48Checked)(const char *first, const char *last, uint64_t &output);
+    uint64_t (*decode64)(std::string_view input);
+    from_chars_result (*decode64Checked)(const char *first, const char *last, uint64_t &output);
+    unsigned __int128 (*decode128)(std::string_view input);
+    from_chars_result (*decode128Checked)(const char *first, const char *last,
+                                          unsigned __int128 &output);
+
+    decode_batch_result (*decodeBatch32)(const char *buffer, size_t length, char delimiter,
+                                         uint32_t *out);
+    decode_batch_result (*decodeBatch48)(const char *buffer, size_t length, char delimiter,
+                                         uint64_t *out);
+    decode_batch_result (*decodeBatch64)(const char *buffer, size_t length, char delimiter,
+                                         uint64_t *out);
+    decode_batch_result (*decodeBatch128)(const char *buffer, size_t length, char delimiter,
+                                          std::pair<uint64_t, uint64_t> *out);
+
+    size_t (*encodeBytesLength)(const uint8_t *in, size_t n, ENDIAN order);
+    char *(*encodeBytes)(const uint8_t *in, size_t n, char *out, ENDIAN order);
+    from_chars_result (*decodeBytes)(const char *first, const char *last, uint8_t *out,
+                                     size_t n, ENDIAN order);
+
+    int (*compare)(std::string_view a, std::string_view b, size_t bitSize);
+    size_t (*canonicalizeBatch)(char *buffer, size_t length, char delimiter);
+};
+
+// with SAN_DISPATCH, the kernels for x86-64: the baseline, SSE4.2 (which includes SSSE3),
+// AVX2 with BMI2, and AVX-512 with VBMI
+namespace scalar {
+extern const Kernel kernel;
+}
+namespace sse42 {
+extern const Kernel kernel;
+}
+namespace avx2 {
+extern const Kernel kernel;
+}
+namespace avx512 {
+extern const Kernel kernel;
+}
+
+// without, the only kernel
+namespace SAN_KERNEL {
+extern const Kernel kernel;
+}
+
+} // namespace san
+
+#endif // SAN_KERNEL_H
@@ -1,172 +1,326 @@
-#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <kernel.h>
 #include <san.h>
-#include <tables.h>
+#include <stats.h>
 
 using namespace std;
 
 namespace san {
 
-ERROR valid(const string &input, size_t bitSize) {
-    if (input.empty()) {
-        return ERROR::EMPTY;
+namespace {
+
+#ifdef SAN_DISPATCH
+// the best kernel first
+const Kernel *const kernels[] = {&avx512::kernel, &avx2::kernel, &sse42::kernel,
+                                 &scalar::kernel};
+
+/**
+ * Determines whether the CPU (and the OS) supports the instructions of the kernel.
+ */
+bool supports(const Kernel *kernel) {
+    __builtin_cpu_init();
+    if (kernel == &avx512::kernel) {
+        return supports(&avx2::kernel) && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512vbmi");
+    } else if (kernel == &avx2::kernel) {
+        return supports(&sse42::kernel) && __builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+    } else if (kernel == &sse42::kernel) {
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
     }
+    return true;
+}
 
-    for (char byte : input) {
-        if (byte < 0) {
-            return ERROR::HIGH_BIT;
-        }
-        if (dec[byte] >= 64) {
-            return ERROR::WRONG_CHAR;
+/**
+ * Determines whether the CPU has pdep and pext, but only as slow microcode, i.e., AMD
+ * before Zen 3, where the AVX2 kernel is slower than the SSE4.2 one.
+ */
+bool slowBmi2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_is("bdver4") || __builtin_cpu_is("znver1") ||
+           __builtin_cpu_is("znver2");
+}
+#else
+const Kernel *const kernels[] = {&SAN_KERNEL::kernel};
+
+bool supports(const Kernel *) { return true; }
+
+bool slowBmi2() { return false; }
+#endif
+
+/**
+ * Picks the best kernel the CPU supports.
+ */
+const Kernel *detect() {
+    for (auto kernel : kernels) {
+        if (supports(kernel) && !(strcmp(kernel->name, "avx2") == 0 && slowBmi2())) {
+            return kernel;
         }
     }
+    return kernels[size(kernels) - 1];
+}
+
+/**
+ * The active kernel, detected on first use.
+ */
+atomic<const Kernel *> &active() {
+    static atomic<const Kernel *> kernel{detect()};
+    return kernel;
+}
+
+inline const Kernel &kernel() { return *active().load(memory_order_relaxed); }
 
-    if (bitSize) {
-        size_t maxSize = (bitSize + 5) / 6;
-        size_t size = input.size();
-        if (size > maxSize) {
-            return ERROR::TOO_LONG;
-        } else if (size == maxSize) {
-            auto rest = bitSize % 6;
-            if (rest) {
-                auto firstByte = dec[input.front()];
-                auto usedBits = (1 << rest) - 1;
-                // detect sign, then check consistency of unused bits
-                if (firstByte & 1 << (rest - 1) ? (firstByte | usedBits) != ONES
-                                                : firstByte & ~usedBits) {
-                    return ERROR::TOO_LONG;
-                }
-            }
+} // namespace
+
+const char *activeKernel() { return kernel().name; }
+
+bool useKernel(const char *name) {
+    for (auto kernel : kernels) {
+        if (strcmp(kernel->name, name) == 0 && supports(kernel)) {
+            active().store(kernel, memory_order_relaxed);
+            return true;
         }
     }
+    return false;
+}
 
-    return ERROR::OK;
+ERROR valid(const string &input, size_t bitSize) {
+    auto ec = kernel().valid(input.data(), input.data() + input.size(), bitSize);
+    from_chars_result error{input.data(), ec};
+    countValidations(1, &error, ec != ERROR::OK);
+    return ec;
 }
 
-#define CASE(i)                                                                                    \
-    if (blocks[(i) + 1] != enc[ONES] ? blocks[i] != enc[0] : blocks[i] != enc[ONES]) {             \
-        return {blocks.begin() + (i), blocks.end()};                                               \
-    }
+decode_batch_result validBatch(const char *buffer, size_t length, char delimiter,
+                               size_t bitSize) {
+    decode_batch_result res{buffer + length, ERROR::OK, 0};
+    auto first = [](void *context, from_chars_result error) {
+        auto &res = *static_cast<decode_batch_result *>(context);
+        res.ptr = error.ptr;
+        res.ec = error.ec;
+        return false;
+    };
+    res.count = kernel().validBatch(buffer, length, delimiter, bitSize, first, &res);
+    from_chars_result error{res.ptr, res.ec};
+    countValidations(res.count + (res.ec != ERROR::OK), &error, res.ec != ERROR::OK);
+    return res;
+}
 
-string encode24Signed(int32_t input) {
-    array<char, 4> blocks{
-        enc[input >> 18 & ONES],
-        enc[input >> 12 & ONES],
-        enc[input >> 6 & ONES],
-        enc[input & ONES],
+size_t validBatch(const char *buffer, size_t length, char delimiter, size_t bitSize,
+                  vector<from_chars_result> &errors) {
+    auto all = [](void *context, from_chars_result error) {
+        static_cast<vector<from_chars_result> *>(context)->push_back(error);
+        return true;
     };
-    CASE(0)
-    CASE(1)
-    CASE(2)
-    return {blocks.back()};
-}
-
-string encode32Signed(int32_t input) {
-    array<char, 6> blocks{enc[input >> 30 & ONES], enc[input >> 24 & ONES], enc[input >> 18 & ONES],
-                          enc[input >> 12 & ONES], enc[input >> 6 & ONES],  enc[input & ONES]};
-    CASE(0)
-    CASE(1)
-    CASE(2)
-    CASE(3)
-    CASE(4)
-    return {blocks.back()};
-}
-
-string encode48Signed(int64_t input) {
-    array<char, 8> blocks{enc[input >> 42 & ONES], enc[input >> 36 & ONES], enc[input >> 30 & ONES],
-                          enc[input >> 24 & ONES], enc[input >> 18 & ONES], enc[input >> 12 & ONES],
-                          enc[input >> 6 & ONES],  enc[input & ONES]};
-    CASE(0)
-    CASE(1)
-    CASE(2)
-    CASE(3)
-    CASE(4)
-    CASE(5)
-    CASE(6)
-    return {blocks.back()};
-}
-
-string encode64Signed(int64_t input) {
-    array<char, 11> blocks{
-        enc[input >> 60 & ONES], enc[input >> 54 & ONES], enc[input >> 48 & ONES],
-        enc[input >> 42 & ONES], enc[input >> 36 & ONES], enc[input >> 30 & ONES],
-        enc[input >> 24 & ONES], enc[input >> 18 & ONES], enc[input >> 12 & ONES],
-        enc[input >> 6 & ONES],  enc[input & ONES]};
-    CASE(0)
-    CASE(1)
-    CASE(2)
-    CASE(3)
-    CASE(4)
-    CASE(5)
-    CASE(6)
-    CASE(7)
-    CASE(8)
-    CASE(9)
-    return {blocks.back()};
-}
-
-string encode128Signed(int64_t ab, int64_t cd) {
-    array<char, 22> blocks{
-        enc[ab >> 62 & ONES], enc[ab >> 56 & ONES], enc[ab >> 50 & ONES],
-        enc[ab >> 44 & ONES], enc[ab >> 38 & ONES], enc[ab >> 32 & ONES],
-        enc[ab >> 26 & ONES], enc[ab >> 20 & ONES], enc[ab >> 14 & ONES],
-        enc[ab >> 8 & ONES],  enc[ab >> 2 & ONES],  enc[(ab << 4 & 0x30) | (cd >> 60 & 0x0f)],
-        enc[cd >> 54 & ONES], enc[cd >> 48 & ONES], enc[cd >> 42 & ONES],
-        enc[cd >> 36 & ONES], enc[cd >> 30 & ONES], enc[cd >> 24 & ONES],
-        enc[cd >> 18 & ONES], enc[cd >> 12 & ONES], enc[cd >> 6 & ONES],
-        enc[cd & ONES]};
-
-    CASE(0)
-    CASE(1)
-    CASE(2)
-    CASE(3)
-    CASE(4)
-    CASE(5)
-    CASE(6)
-    CASE(7)
-    CASE(8)
-    CASE(9)
-    CASE(10)
-    CASE(11)
-    CASE(12)
-    CASE(13)
-    CASE(14)
-    CASE(15)
-    CASE(16)
-    CASE(17)
-    CASE(18)
-    CASE(19)
-    CASE(20)
-    return {blocks.back()};
-}
-
-uint32_t decode24(const string &input) { return decode32(input) & (1u << 24) - 1; }
-
-uint32_t decode32(const string &input) {
-    auto res = input.front() == enc[ONES] ? -1u : 0;
-    for (char byte : input) {
-        res = (res << 6) + dec[byte];
-    }
+    auto known = errors.size();
+    auto count = kernel().validBatch(buffer, length, delimiter, bitSize, all, &errors);
+    countValidations(count, errors.data() + known, errors.size() - known);
+    return count;
+}
+
+to_chars_result encode24Signed(char *first, char *last, int32_t input) {
+    auto res = kernel().encode24Signed(first, last, input);
+    countEncoding<24>(first, res);
     return res;
 }
 
-uint64_t decode48(const string &input) { return decode64(input) & (1ul << 48) - 1; }
+to_chars_result encode32Signed(char *first, char *last, int32_t input) {
+    auto res = kernel().encode32Signed(first, last, input);
+    countEncoding<32>(first, res);
+    return res;
+}
 
-uint64_t decode64(const string &input) {
-    auto res = input.front() == enc[ONES] ? -1ul : 0;
-    for (char byte : input) {
-        res = (res << 6) + dec[byte];
-    }
+to_chars_result encode48Signed(char *first, char *last, int64_t input) {
+    auto res = kernel().encode48Signed(first, last, input);
+    countEncoding<48>(first, res);
+    return res;
+}
+
+to_chars_result encode64Signed(char *first, char *last, int64_t input) {
+    auto res = kernel().encode64Signed(first, last, input);
+    countEncoding<64>(first, res);
     return res;
 }
 
-pair<uint64_t, uint64_t> decode128(const string &input) {
-    uint64_t ab = input.front() == enc[ONES] ? -1ul : 0;
-    uint64_t cd = ab;
-    for (char byte : input) {
-        ab = (ab << 6) + (cd >> 58 & ONES);
-        cd = (cd << 6) + dec[byte];
+to_chars_result encode128Signed(char *first, char *last, int64_t ab, int64_t cd) {
+    return encode128Signed(first, last,
+                           static_cast<__int128>(static_cast<unsigned __int128>(ab) << 64 |
+                                                 static_cast<uint64_t>(cd)));
+}
+
+to_chars_result encode128Signed(char *first, char *last, __int128 input) {
+    auto res = kernel().encode128Signed(first, last, input);
+    countEncoding<128>(first, res);
+    return res;
+}
+
+char *encodeBatch32(const int32_t *in, size_t n, char *out, uint32_t *offsets) {
+    auto end = kernel().encodeBatch32(in, n, out, offsets);
+    countEncodings<32>(out, n, offsets);
+    return end;
+}
+
+char *encodeBatch48(const int64_t *in, size_t n, char *out, uint32_t *offsets) {
+    auto end = kernel().encodeBatch48(in, n, out, offsets);
+    countEncodings<48>(out, n, offsets);
+    return end;
+}
+
+char *encodeBatch64(const int64_t *in, size_t n, char *out, uint32_t *offsets) {
+    auto end = kernel().encodeBatch64(in, n, out, offsets);
+    countEncodings<64>(out, n, offsets);
+    return end;
+}
+
+char *encodeBatch128(const pair<int64_t, int64_t> *in, size_t n, char *out, uint32_t *offsets) {
+    auto end = kernel().encodeBatch128(in, n, out, offsets);
+    countEncodings<128>(out, n, offsets);
+    return end;
+}
+
+uint32_t decode24(string_view input) {
+    countDecoding<24>();
+    return kernel().decode24(input);
+}
+
+from_chars_result decode24(const char *first, const char *last, uint32_t &output) {
+    auto res = kernel().decode24Checked(first, last, output);
+    countDecoding<24>(res.ec);
+    return res;
+}
+
+uint32_t decode32(string_view input) {
+    countDecoding<32>();
+    return kernel().decode32(input);
+}
+
+from_chars_result decode32(const char *first, const char *last, uint32_t &output) {
+    auto res = kernel().decode32Checked(first, last, output);
+    countDecoding<32>(res.ec);
+    return res;
+}
+
+uint64_t decode48(string_view input) {
+    countDecoding<48>();
+    return kernel().decode48(input);
+}
+
+from_chars_result decode48(const char *first, const char *last, uint64_t &output) {
+    auto res = kernel().decode48Checked(first, last, output);
+    countDecoding<48>(res.ec);
+    return res;
+}
+
+uint64_t decode64(string_view input) {
+    countDecoding<64>();
+    return kernel().decode64(input);
+}
+
+from_chars_result decode64(const char *first, const char *last, uint64_t &output) {
+    auto res = kernel().decode64Checked(first, last, output);
+    countDecoding<64>(res.ec);
+    return res;
+}
+
+pair<uint64_t, uint64_t> decode128(string_view input) {
+    auto res = decode128Native(input);
+    return {static_cast<uint64_t>(res >> 64), static_cast<uint64_t>(res)};
+}
+
+from_chars_result decode128(const char *first, const char *last, pair<uint64_t, uint64_t> &output) {
+    unsigned __int128 res;
+    auto result = decode128(first, last, res);
+    if (result.ec == ERROR::OK) {
+        output = {static_cast<uint64_t>(res >> 64), static_cast<uint64_t>(res)};
     }
-    return {ab, cd};
+    return result;
+}
+
+unsigned __int128 decode128Native(string_view input) {
+    countDecoding<128>();
+    return kernel().decode128(input);
+}
+
+from_chars_result decode128(const char *first, const char *last, unsigned __int128 &output) {
+    auto res = kernel().decode128Checked(first, last, output);
+    countDecoding<128>(res.ec);
+    return res;
+}
+
+decode_batch_result decodeBatch32(const char *buffer, size_t length, char delimiter,
+                                  uint32_t *out) {
+    auto res = kernel().decodeBatch32(buffer, length, delimiter, out);
+    countDecodings<32>(res);
+    return res;
+}
+
+decode_batch_result decodeBatch48(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out) {
+    auto res = kernel().decodeBatch48(buffer, length, delimiter, out);
+    countDecodings<48>(res);
+    return res;
+}
+
+decode_batch_result decodeBatch64(const char *buffer, size_t length, char delimiter,
+                                  uint64_t *out) {
+    auto res = kernel().decodeBatch64(buffer, length, delimiter, out);
+    countDecodings<64>(res);
+    return res;
+}
+
+decode_batch_result decodeBatch128(const char *buffer, size_t length, char delimiter,
+                                   pair<uint64_t, uint64_t> *out) {
+    auto res = kernel().decodeBatch128(buffer, length, delimiter, out);
+    countDecodings<128>(res);
+    return res;
+}
+
+size_t canonicalizeBatch(char *buffer, size_t length, char delimiter) {
+    countCanonicalization();
+    return kernel().canonicalizeBatch(buffer, length, delimiter);
+}
+
+size_t encodeBytesLength(const uint8_t *in, size_t n, ENDIAN order) {
+    return kernel().encodeBytesLength(in, n, order);
+}
+
+char *encodeBytes(const uint8_t *in, size_t n, char *out, ENDIAN order) {
+    countBytesEncoding();
+    return kernel().encodeBytes(in, n, out, order);
+}
+
+from_chars_result decodeBytes(const char *first, const char *last, uint8_t *out, size_t n,
+                              ENDIAN order) {
+    auto res = kernel().decodeBytes(first, last, out, n, order);
+    countBytesDecoding(res.ec);
+    return res;
+}
+
+int compare24(string_view a, string_view b) {
+    countCompare<24>();
+    return kernel().compare(a, b, 24);
+}
+
+int compare32(string_view a, string_view b) {
+    countCompare<32>();
+    return kernel().compare(a, b, 32);
+}
+
+int compare48(string_view a, string_view b) {
+    countCompare<48>();
+    return kernel().compare(a, b, 48);
+}
+
+int compare64(string_view a, string_view b) {
+    countCompare<64>();
+    return kernel().compare(a, b, 64);
+}
+
+int compare128(string_view a, string_view b) {
+    countCompare<128>();
+    return kernel().compare(a, b, 128);
 }
 
 } // namespace san
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <stats.h>
+#include <vector>
+
+using namespace std;
+
+namespace san {
+
+namespace {
+
+/**
+ * Applies the function to each pair of counters of the two snapshots.
+ */
+template <typename F> void forEach(stats &to, const stats &from, F f) {
+    for (size_t i = 0; i < size(to.widths); ++i) {
+        f(to.widths[i].encodes, from.widths[i].encodes);
+        f(to.widths[i].decodes, from.widths[i].decodes);
+        f(to.widths[i].compares, from.widths[i].compares);
+        for (size_t j = 0; j < size(to.widths[i].lengths); ++j) {
+            f(to.widths[i].lengths[j], from.widths[i].lengths[j]);
+        }
+        f(to.widths[i].extraPlus, from.widths[i].extraPlus);
+        f(to.widths[i].extraMinus, from.widths[i].extraMinus);
+    }
+    f(to.validations, from.validations);
+    f(to.canonicalizations, from.canonicalizations);
+    f(to.byteEncodes, from.byteEncodes);
+    f(to.byteDecodes, from.byteDecodes);
+    for (size_t i = 0; i < size(to.errors); ++i) {
+        f(to.errors[i], from.errors[i]);
+    }
+}
+
+/**
+ * The counters of the running threads, the sum of the finished ones, and the sum of all
+ * at the last reset, which snapshots subtract.
+ */
+struct Registry {
+    mutex lock;
+    vector<const stats *> threads;
+    stats finished{};
+    stats baseline{};
+
+    stats sum() {
+        auto sum = finished;
+        for (auto counters : threads) {
+            forEach(sum, *counters, [](uint64_t &to, const uint64_t &from) {
+                to += __atomic_load_n(&from, __ATOMIC_RELAXED);
+            });
+        }
+        return sum;
+    }
+};
+
+Registry &registry() {
+    static Registry registry;
+    return registry;
+}
+
+/**
+ * The counters of a thread, which are added to the finished ones when it ends.
+ */
+struct ThreadStats {
+    stats counters{};
+
+    ThreadStats() {
+        auto &all = registry();
+        lock_guard<mutex> guard(all.lock);
+        all.threads.push_back(&counters);
+    }
+
+    ~ThreadStats() {
+        auto &all = registry();
+        lock_guard<mutex> guard(all.lock);
+        all.finished += counters;
+        all.threads.erase(find(all.threads.begin(), all.threads.end(), &counters));
+    }
+};
+
+} // namespace
+
+stats &threadStats() {
+    thread_local ThreadStats mine;
+    return mine.counters;
+}
+
+stats &stats::operator+=(const stats &other) {
+    forEach(*this, other, [](uint64_t &to, const uint64_t &from) { to += from; });
+    return *this;
+}
+
+stats collectStats() {
+    auto &all = registry();
+    lock_guard<mutex> guard(all.lock);
+    auto sum = all.sum();
+    forEach(sum, all.baseline, [](uint64_t &to, const uint64_t &from) { to -= from; });
+    return sum;
+}
+
+void resetStats() {
+    auto &all = registry();
+    lock_guard<mutex> guard(all.lock);
+    all.baseline = all.sum();
+}
+
+} // namespace san
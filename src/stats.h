@@ -0,0 +1,126 @@
+#ifndef SAN_STATS_H
+#define SAN_STATS_H
+
+#include <san.h>
+#include <tables.h>
+
+namespace san {
+
+#ifdef SAN_STATS
+constexpr bool STATS = true;
+#else
+constexpr bool STATS = false;
+#endif
+
+/**
+ * The usage counters of the calling thread, which are only written by it and registered
+ * for collectStats() on first use.
+ */
+stats &threadStats();
+
+/**
+ * Adds to a counter of the calling thread: it is the only writer, so this needs no atomic
+ * read-modify-write, just a load and a store that snapshots of other threads cannot tear.
+ */
+inline void count(uint64_t &counter, uint64_t n = 1) {
+    __atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+template <size_t Bits> stats::width &widthStats() {
+    constexpr size_t index = Bits == 24 ? 0 : Bits == 32 ? 1 : Bits == 48 ? 2 : Bits == 64 ? 3 : 4;
+    return threadStats().widths[index];
+}
+
+inline void countError(ERROR ec) {
+    if (ec != ERROR::OK) {
+        count(threadStats().errors[static_cast<size_t>(ec)]);
+    }
+}
+
+template <size_t Bits> void countEncoding(const char *first, size_t length) {
+    auto &width = widthStats<Bits>();
+    count(width.encodes);
+    count(width.lengths[length]);
+    if (length > 1 && first[0] == enc[0]) {
+        count(width.extraPlus);
+    } else if (length > 1 && first[0] == enc[ONES]) {
+        count(width.extraMinus);
+    }
+}
+
+template <size_t Bits> void countEncoding(const char *first, to_chars_result res) {
+    if constexpr (STATS) {
+        if (res.ec == ERROR::OK) {
+            countEncoding<Bits>(first, static_cast<size_t>(res.ptr - first));
+        } else {
+            count(widthStats<Bits>().encodes);
+            countError(res.ec);
+        }
+    }
+}
+
+template <size_t Bits> void countEncodings(const char *out, size_t n, const uint32_t *offsets) {
+    if constexpr (STATS) {
+        for (size_t i = 0; i < n; ++i) {
+            countEncoding<Bits>(out + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+    }
+}
+
+template <size_t Bits> void countDecoding(ERROR ec = ERROR::OK) {
+    if constexpr (STATS) {
+        count(widthStats<Bits>().decodes);
+        countError(ec);
+    }
+}
+
+template <size_t Bits> void countDecodings(decode_batch_result res) {
+    if constexpr (STATS) {
+        count(widthStats<Bits>().decodes, res.count + (res.ec != ERROR::OK));
+        countError(res.ec);
+    }
+}
+
+template <size_t Bits> void countCompare() {
+    if constexpr (STATS) {
+        count(widthStats<Bits>().compares);
+    }
+}
+
+inline void countCanonicalization() {
+    if constexpr (STATS) {
+        count(threadStats().canonicalizations);
+    }
+}
+
+inline void countBytesEncoding() {
+    if constexpr (STATS) {
+        count(threadStats().byteEncodes);
+    }
+}
+
+/**
+ * Counts a call of decodeBytes(), which may have failed.
+ */
+inline void countBytesDecoding(ERROR ec) {
+    if constexpr (STATS) {
+        count(threadStats().byteDecodes);
+        countError(ec);
+    }
+}
+
+/**
+ * Counts validations, of which the given ones failed.
+ */
+inline void countValidations(size_t n, const from_chars_result *errors, size_t failed) {
+    if constexpr (STATS) {
+        count(threadStats().validations, n);
+        for (size_t i = 0; i < failed; ++i) {
+            countError(errors[i].ec);
+        }
+    }
+}
+
+} // namespace san
+
+#endif // SAN_STATS_H
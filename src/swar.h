@@ -0,0 +1,157 @@
+#ifndef SAN_SWAR_H
+#define SAN_SWAR_H
+
+#include <cstdint>
+#include <cstring>
+
+#include <kernel.h>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace san {
+namespace SAN_KERNEL {
+namespace swar {
+
+// SIMD within a register: we handle up to 8 characters in the bytes of a 64-bit word
+
+constexpr uint64_t LOW = 0x0101010101010101;
+constexpr uint64_t HIGH = 0x8080808080808080;
+constexpr uint64_t BLOCKS = 0x3f3f3f3f3f3f3f3f;
+
+/**
+ * Converts loaded words to big endian, so the first character is the most significant one.
+ */
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline uint64_t bigEndian(uint64_t x) { return __builtin_bswap64(x); }
+inline uint32_t bigEndian(uint32_t x) { return __builtin_bswap32(x); }
+#else
+inline uint64_t bigEndian(uint64_t x) { return x; }
+inline uint32_t bigEndian(uint32_t x) { return x; }
+#endif
+
+/**
+ * Loads 8 characters, so the first character ends up in the most significant byte.
+ */
+inline uint64_t load(const char *p) {
+    uint64_t res;
+    memcpy(&res, p, 8);
+    return bigEndian(res);
+}
+
+/**
+ * Loads 1-8 characters, without reading beyond them, so the first character
+ * ends up in the most significant used byte and the last one in the lowest byte.
+ * Shorter inputs are assembled from overlapping loads.
+ */
+inline uint64_t load(const char *p, size_t n) {
+    if (n >= 4) {
+        uint32_t high, low;
+        memcpy(&high, p, 4);
+        memcpy(&low, p + n - 4, 4);
+        return static_cast<uint64_t>(bigEndian(high)) << 8 * (n - 4) | bigEndian(low);
+    }
+    // for 1-3 characters, the middle one is the first or last one for n < 3
+    uint64_t first = static_cast<uint8_t>(p[0]);
+    uint64_t middle = static_cast<uint8_t>(p[n / 2]);
+    uint64_t last = static_cast<uint8_t>(p[n - 1]);
+    return first << 8 * (n - 1) | middle << 8 * (n - 1 - n / 2) | last;
+}
+
+/**
+ * Maps characters to their 6-bit blocks with arithmetic range tests instead of the
+ * decode table. We subtract '+' from every byte with its high bit set, so each byte
+ * holds the distance x from '+' plus 0x80 (or less than 0x80 for bytes below '+').
+ * Testing x >= n then is another subtraction, which never borrows from the next
+ * byte, and the mapping is a sum of offsets for the ranges x has reached:
+ *
+ *  character  '+'  '-'  '0'  '1'-'9'  'A'-'Z'  'a'-'z'
+ *  x            0    2    5   6-14    22-47    54-79
+ *  block        0   63   62    1-9    36-61    10-35
+ *
+ * @param chars the characters, one per byte
+ * @param blocks receives the 6-bit block in the lower bits of every byte
+ * @return a mask with the high bit set in the byte of every invalid character
+ */
+inline uint64_t decodeBytes(uint64_t chars, uint64_t &blocks) {
+    auto biased = (chars | HIGH) - LOW * '+';
+    auto atLeast = [biased](uint8_t n) { return (biased - LOW * n) & HIGH; };
+    auto minus = atLeast('-' - '+');
+    auto zero = atLeast('0' - '+');
+    auto digit = atLeast('1' - '+');
+    auto upper = atLeast('A' - '+');
+    auto lower = atLeast('a' - '+');
+
+    // higher ranges inherit the offsets of the lower ones; in this order,
+    // the partial sums stay within each byte for any input
+    blocks = biased - (digit >> 7) * 62 + (minus >> 7) * 61 - (zero >> 7) * 4 +
+             (upper >> 7) * 19 - (lower >> 7) * 58;
+
+    auto valid = (biased & HIGH & ~atLeast(1)) | (minus & ~atLeast('-' - '+' + 1)) |
+                 (zero & ~digit) | (digit & ~atLeast('9' - '+' + 1)) |
+                 (upper & ~atLeast('Z' - '+' + 1)) | (lower & ~atLeast('z' - '+' + 1));
+    return (~valid | chars) & HIGH;
+}
+
+/**
+ * Packs the 6-bit blocks of the bytes into a contiguous 48-bit value, i.e., the inverse
+ * of spreading them over the bytes, which is a single pext instruction with BMI2.
+ */
+inline uint64_t pack(uint64_t blocks) {
+#ifdef __BMI2__
+    return _pext_u64(blocks, BLOCKS);
+#else
+    blocks &= BLOCKS;
+    blocks = (blocks & 0x003f003f003f003f) | (blocks & 0x3f003f003f003f00) >> 2;
+    blocks = (blocks & 0x00000fff00000fff) | (blocks & 0x0fff00000fff0000) >> 4;
+    return (blocks & 0x0000000000ffffff) | (blocks & 0x00ffffff00000000) >> 8;
+#endif
+}
+
+/**
+ * Decodes 1-8 characters into their packed 6-bit blocks.
+ *
+ * @param p the characters
+ * @param n the number of characters
+ * @param value receives the decoded blocks, the first character being most significant
+ * @return a mask with the high bit set in the byte of every invalid character
+ */
+inline uint64_t decode(const char *p, size_t n, uint64_t &value) {
+    uint64_t blocks;
+    auto invalid = decodeBytes(load(p, n), blocks);
+    // ignore the bytes beyond the input
+    auto used = ~0ul >> (64 - 8 * n);
+    value = pack(blocks & used);
+    return invalid & used;
+}
+
+/**
+ * Decodes exactly 8 characters into their packed 6-bit blocks, see decode(p, n, value).
+ */
+inline uint64_t decode(const char *p, uint64_t &value) {
+    uint64_t blocks;
+    auto invalid = decodeBytes(load(p), blocks);
+    value = pack(blocks);
+    return invalid;
+}
+
+/**
+ * Determines the index of the first invalid character of a decode() call.
+ *
+ * @param invalid the non-zero mask returned by decode()
+ * @param n the number of decoded characters
+ * @return the index of the first invalid character
+ */
+inline size_t firstInvalid(uint64_t invalid, size_t n) {
+    return n - 1 - (63 - __builtin_clzll(invalid)) / 8;
+}
+
+} // namespace swar
+} // namespace SAN_KERNEL
+
+namespace swar = SAN_KERNEL::swar;
+
+} // namespace san
+
+#endif // SAN_SWAR_H
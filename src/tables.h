@@ -1,24 +1,60 @@
 #ifndef SAN_TABLES_H
 #define SAN_TABLES_H
 
+#include <array>
+#include <cstdint>
+#include <sanCodec.h>
+#include <utility>
+
 namespace san {
 
 constexpr uint8_t ONES = 0x3f;
 
-constexpr char enc[65] = "+123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0-";
-constexpr char dec[129] = "@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@"
-                          "\x00" // +
-                          "@"
-                          "\x3f" // -
-                          "@@"
-                          "\x3e\x01\x02\x03\x04\x05\x06\x07\x08\x09" // 0-9
-                          "@@@@@@@"
-                          "\x24\x25\x26\x27\x28\x29\x2a\x2b\x2c\x2d\x2e\x2f\x30" // A-M
-                          "\x31\x32\x33\x34\x35\x36\x37\x38\x39\x3a\x3b\x3c\x3d" // N-Z
-                          "@@@@@@"
-                          "\x0a\x0b\x0c\x0d\x0e\x0f\x10\x11\x12\x13\x14\x15\x16" // a-m
-                          "\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f\x20\x21\x22\x23" // n-z
-                          "@@@@@";
+// the default alphabet, see sanCodec.h
+inline constexpr const char (&enc)[65] = default_alphabet::chars;
+
+/**
+ * The decode table of the default alphabet as characters, i.e., with '@' (64) for invalid
+ * ones, and with a terminating NUL like a string literal.
+ */
+template <typename Indices> struct DecodeChars;
+
+template <size_t... I> struct DecodeChars<std::index_sequence<I...>> {
+    static constexpr char chars[129] = {static_cast<char>(codec::dec[I])..., '\0'};
+};
+
+inline constexpr const char (&dec)[129] = DecodeChars<std::make_index_sequence<128>>::chars;
+
+// two blocks (12 bit) or characters at a time, see SAN_TABLES=PAIR
+
+/**
+ * Generates the characters of every pair of blocks, i.e., of the 12-bit value i at 2 * i.
+ */
+constexpr std::array<char, 2 * 4096> makeEncPairs() {
+    std::array<char, 2 * 4096> pairs{};
+    for (size_t i = 0; i < 4096; ++i) {
+        pairs[2 * i] = enc[i >> 6];
+        pairs[2 * i + 1] = enc[i & ONES];
+    }
+    return pairs;
+}
+
+/**
+ * Generates the 12-bit value of every pair of 7-bit characters, at their concatenated
+ * 14-bit index, marking pairs with an invalid character by a value of at least 4096.
+ */
+constexpr std::array<uint16_t, 128 * 128> makeDecPairs() {
+    std::array<uint16_t, 128 * 128> pairs{};
+    for (size_t i = 0; i < 128 * 128; ++i) {
+        auto first = static_cast<uint16_t>(dec[i >> 7]);
+        auto second = static_cast<uint16_t>(dec[i & 0x7f]);
+        pairs[i] = first < 64 && second < 64 ? first << 6 | second : 4096;
+    }
+    return pairs;
+}
+
+inline constexpr auto encPairs = makeEncPairs();
+inline constexpr auto decPairs = makeDecPairs();
 
 } // namespace san
 
@@ -0,0 +1,351 @@
+#ifndef SAN_X86_H
+#define SAN_X86_H
+
+#ifdef __SSSE3__
+#define SAN_X86_SSSE3
+#ifdef __BMI2__
+#define SAN_X86
+#endif
+#if defined(SAN_X86) && defined(__AVX2__)
+#define SAN_X86_AVX2
+#endif
+#if defined(SAN_X86_AVX2) && defined(__AVX512BW__) && defined(__AVX512VBMI__) &&                  \
+    defined(__AVX512VL__)
+#define SAN_X86_AVX512
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <kernel.h>
+#include <tables.h>
+
+namespace san {
+namespace SAN_KERNEL {
+namespace x86 {
+
+// single values with BMI2 and SSSE3: pdep/pext move the 6-bit blocks between a value and
+// the bytes of a vector, and pshufb maps the bytes between blocks and characters (with
+// AVX-512 VBMI, vpermb looks them up in the tables directly); SSSE3 alone suffices to
+// classify characters, see classify()
+
+constexpr uint64_t BLOCKS = 0x3f3f3f3f3f3f3f3f;
+
+#ifdef SAN_X86
+/**
+ * Spreads the 6-bit blocks of two 48-bit parts over the bytes of a vector, i.e.,
+ * byte j holds block j, counting from the least significant block of the low part.
+ */
+inline __m128i spread(uint64_t low, uint64_t high) {
+    return _mm_set_epi64x(static_cast<int64_t>(_pdep_u64(high, BLOCKS)),
+                          static_cast<int64_t>(_pdep_u64(low, BLOCKS)));
+}
+#endif
+
+/**
+ * The index of every byte, i.e., 0, 1, ..., 15.
+ */
+inline __m128i indices() {
+    return _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+}
+
+/**
+ * Reverses the first `count` bytes, so the most significant block comes first.
+ */
+inline __m128i reverse(__m128i blocks, int count) {
+    // the indices of the bytes beyond count become negative, which zeroes them
+    auto reversed = _mm_sub_epi8(_mm_set1_epi8(static_cast<char>(count - 1)), indices());
+    return _mm_shuffle_epi8(blocks, reversed);
+}
+
+/**
+ * Maps every byte, a block in the range 0-63, to its character. The number of ranges
+ * a block exceeds (0, 1-9, 10-35, 36-61, 62, 63) selects the offset to add.
+ */
+inline __m128i toChars(__m128i blocks) {
+#ifdef SAN_X86_AVX512
+    auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(enc));
+    auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(enc + 32));
+    auto index = _mm256_castsi128_si256(blocks);
+    return _mm256_castsi256_si128(_mm256_permutex2var_epi8(low, index, high));
+#else
+    auto range = _mm_sub_epi8(_mm_setzero_si128(), _mm_cmpgt_epi8(blocks, _mm_setzero_si128()));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(blocks, _mm_set1_epi8(9)));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(blocks, _mm_set1_epi8(35)));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(blocks, _mm_set1_epi8(61)));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(blocks, _mm_set1_epi8(62)));
+    auto offsets = _mm_setr_epi8('+', '1' - 1, 'a' - 10, 'A' - 36, '0' - 62, '-' - 63, 0, 0, 0, 0,
+                                 0, 0, 0, 0, 0, 0);
+    return _mm_add_epi8(blocks, _mm_shuffle_epi8(offsets, range));
+#endif
+}
+
+/**
+ * Loads the `count` (1-16) characters before `last`, so the last character ends up in
+ * the highest byte. If the whole vector lies in the page of the last character, we load
+ * it directly, which may read (but ignore) bytes before the input, but never faults.
+ */
+__attribute__((no_sanitize_address)) inline __m128i loadRight(const char *last, size_t count) {
+    if ((reinterpret_cast<uintptr_t>(last - 1) & 4095) >= 15) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(last - 16));
+    }
+    alignas(16) char buffer[16] = {};
+    memcpy(buffer + 16 - count, last - count, count);
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(buffer));
+}
+
+/**
+ * The classes of the low nibbles of the characters, see toBlocks().
+ */
+inline __m128i lowClasses() {
+    return _mm_setr_epi8(2 | 8, 2 | 4 | 8, 2 | 4 | 8, 2 | 4 | 8, 2 | 4 | 8, 2 | 4 | 8, 2 | 4 | 8,
+                         2 | 4 | 8, 2 | 4 | 8, 2 | 4 | 8, 4 | 8, 1 | 4, 4, 1 | 4, 4, 4);
+}
+
+/**
+ * The classes of the high nibbles of the characters, see toBlocks().
+ */
+inline __m128i highClasses() {
+    return _mm_setr_epi8(0, 0, 1, 2, 4, 8, 4, 8, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+/**
+ * Maps every byte from its character to its block, like the decode table. The high
+ * nibble selects the offset, except for '-' and '0', which we fix on their own. Valid
+ * characters are those, whose low nibble has a class in common with their high nibble:
+ * '+' and '-' (1), digits (2), letters before 'P' or 'p' (4), and the remaining ones (8).
+ *
+ * @param chars the characters, one per byte
+ * @param blocks receives the block of every valid character
+ * @return a mask with bit i set if the character in byte i is invalid
+ */
+inline uint32_t toBlocks(__m128i chars, __m128i &blocks) {
+#ifdef SAN_X86_AVX512
+    // two lookups of 64 entries, the decode table marks invalid characters with 64 ('@')
+    auto index = _mm256_castsi128_si256(chars);
+    auto table = reinterpret_cast<const __m256i *>(dec);
+    auto low = _mm256_permutex2var_epi8(_mm256_loadu_si256(table), index,
+                                        _mm256_loadu_si256(table + 1));
+    auto high = _mm256_permutex2var_epi8(_mm256_loadu_si256(table + 2), index,
+                                         _mm256_loadu_si256(table + 3));
+    auto upper = _mm256_test_epi8_mask(index, _mm256_set1_epi8(0x40));
+    blocks = _mm256_castsi256_si128(_mm256_mask_blend_epi8(upper, low, high));
+    auto invalid = _mm_movemask_epi8(_mm_or_si128(chars, _mm_add_epi8(blocks, blocks)));
+    return static_cast<uint32_t>(invalid);
+#else
+    auto nibbles = _mm_set1_epi8(0x0f);
+    auto high = _mm_and_si128(_mm_srli_epi16(chars, 4), nibbles);
+    auto low = _mm_and_si128(chars, nibbles);
+
+    auto classes =
+        _mm_and_si128(_mm_shuffle_epi8(lowClasses(), low), _mm_shuffle_epi8(highClasses(), high));
+    auto invalid = _mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_setzero_si128()));
+
+    auto offsets = _mm_setr_epi8(0, 0, -'+', -'1' + 1, -'A' + 36, -'A' + 36, -'a' + 10,
+                                 -'a' + 10, 0, 0, 0, 0, 0, 0, 0, 0);
+    blocks = _mm_add_epi8(chars, _mm_shuffle_epi8(offsets, high));
+    auto minus = _mm_and_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('-')), _mm_set1_epi8(61));
+    auto zero = _mm_and_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('0')), _mm_set1_epi8(62));
+    blocks = _mm_add_epi8(blocks, _mm_add_epi8(minus, zero));
+    return static_cast<uint32_t>(invalid);
+#endif
+}
+
+#ifdef SAN_X86
+/**
+ * Packs the `count` blocks before byte `end` of a vector into a contiguous value, the
+ * byte before `end` being the least significant block.
+ */
+inline unsigned __int128 pack(__m128i blocks, int end, int count) {
+    // reverse the bytes before end, but zero those beyond count
+    auto unused = _mm_cmpgt_epi8(indices(), _mm_set1_epi8(static_cast<char>(count - 1)));
+    auto reversed = _mm_shuffle_epi8(
+        blocks, _mm_or_si128(_mm_sub_epi8(_mm_set1_epi8(static_cast<char>(end - 1)), indices()),
+                             unused));
+    auto low = static_cast<uint64_t>(_mm_cvtsi128_si64(reversed));
+    auto high = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(reversed, reversed)));
+    return static_cast<unsigned __int128>(_pext_u64(high, BLOCKS)) << 48 | _pext_u64(low, BLOCKS);
+}
+#endif
+
+/**
+ * The bit of the high nibble of a 7-bit character in a set, see toSet().
+ */
+inline __m128i setBits() {
+    return _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+/**
+ * Turns a set of 7-bit characters, a mask indexed by the character, into a lookup table
+ * for classify(): byte l has bit h set, if the character with the low nibble l and the
+ * high nibble h is in the set.
+ */
+inline __m128i toSet(unsigned __int128 set) {
+    alignas(16) uint8_t bytes[16] = {};
+    for (int c = 0; c < 128; ++c) {
+        bytes[c & 15] |= static_cast<uint8_t>((set >> c & 1) << (c >> 4));
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+}
+
+/**
+ * Finds some characters among 64 characters, loading each vector once.
+ *
+ * @param targets the characters to find
+ * @param masks receives a mask per target with bit i set if character i is that target
+ */
+template <size_t N>
+inline void find(const char *chars, const char (&targets)[N], uint64_t (&masks)[N]) {
+    for (auto &mask : masks) {
+        mask = 0;
+    }
+#ifdef SAN_X86_AVX2
+    for (int i = 0; i < 64; i += 32) {
+        auto vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(chars + i));
+        for (size_t k = 0; k < N; ++k) {
+            auto found = _mm256_cmpeq_epi8(vector, _mm256_set1_epi8(targets[k]));
+            masks[k] |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(found)))
+                        << i;
+        }
+    }
+#else
+    for (int i = 0; i < 64; i += 16) {
+        auto vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(chars + i));
+        for (size_t k = 0; k < N; ++k) {
+            auto found = _mm_movemask_epi8(_mm_cmpeq_epi8(vector, _mm_set1_epi8(targets[k])));
+            masks[k] |= static_cast<uint64_t>(static_cast<uint16_t>(found)) << i;
+        }
+    }
+#endif
+}
+
+#if !defined(SAN_X86_AVX2)
+
+/**
+ * Classifies 64 characters at once: whether they are valid (see toBlocks()), the delimiter,
+ * or members of a set.
+ *
+ * @param chars the characters
+ * @param delimiter the character between tokens
+ * @param set the set of characters, see toSet()
+ * @param delimiters receives a mask with bit i set if character i is the delimiter
+ * @param members receives a mask with bit i set if character i is in the set
+ * @return a mask with bit i set if character i is neither valid nor the delimiter
+ */
+inline uint64_t classify(const char *chars, char delimiter, __m128i set, uint64_t &delimiters,
+                         uint64_t &members) {
+    auto nibbles = _mm_set1_epi8(0x0f);
+    uint64_t invalid = 0;
+    delimiters = 0;
+    members = 0;
+    for (int i = 0; i < 64; i += 16) {
+        auto vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(chars + i));
+        auto high = _mm_and_si128(_mm_srli_epi16(vector, 4), nibbles);
+        auto low = _mm_and_si128(vector, nibbles);
+        auto classes = _mm_and_si128(_mm_shuffle_epi8(lowClasses(), low),
+                                     _mm_shuffle_epi8(highClasses(), high));
+        auto ends = _mm_cmpeq_epi8(vector, _mm_set1_epi8(delimiter));
+        auto wrong = _mm_andnot_si128(ends, _mm_cmpeq_epi8(classes, _mm_setzero_si128()));
+        auto in = _mm_and_si128(_mm_shuffle_epi8(set, low), _mm_shuffle_epi8(setBits(), high));
+        auto out = _mm_cmpeq_epi8(in, _mm_setzero_si128());
+        invalid |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(wrong))) << i;
+        delimiters |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(ends))) << i;
+        members |= static_cast<uint64_t>(static_cast<uint16_t>(~_mm_movemask_epi8(out))) << i;
+    }
+    return invalid;
+}
+
+#else
+
+/**
+ * Maps every byte of both halves, a block in the range 0-63, to its character, see
+ * toChars(__m128i).
+ */
+inline __m256i toChars(__m256i blocks) {
+#ifdef SAN_X86_AVX512
+    auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(enc));
+    auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(enc + 32));
+    return _mm256_permutex2var_epi8(low, blocks, high);
+#else
+    auto range = _mm256_sub_epi8(_mm256_setzero_si256(),
+                                 _mm256_cmpgt_epi8(blocks, _mm256_setzero_si256()));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(blocks, _mm256_set1_epi8(9)));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(blocks, _mm256_set1_epi8(35)));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(blocks, _mm256_set1_epi8(61)));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(blocks, _mm256_set1_epi8(62)));
+    auto offsets = _mm256_setr_epi8('+', '1' - 1, 'a' - 10, 'A' - 36, '0' - 62, '-' - 63, 0, 0,
+                                    0, 0, 0, 0, 0, 0, 0, 0, '+', '1' - 1, 'a' - 10, 'A' - 36,
+                                    '0' - 62, '-' - 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    return _mm256_add_epi8(blocks, _mm256_shuffle_epi8(offsets, range));
+#endif
+}
+
+#ifdef SAN_X86_AVX512
+
+/**
+ * Classifies 64 characters at once, see classify() without AVX2. One vpermb looks up
+ * all of them in the decode table.
+ */
+inline uint64_t classify(const char *chars, char delimiter, __m128i set, uint64_t &delimiters,
+                         uint64_t &members) {
+    auto vector = _mm512_loadu_si512(chars);
+    auto blocks = _mm512_permutex2var_epi8(_mm512_loadu_si512(dec), vector,
+                                           _mm512_loadu_si512(dec + 64));
+    delimiters = _mm512_cmpeq_epi8_mask(vector, _mm512_set1_epi8(delimiter));
+
+    auto nibbles = _mm512_set1_epi8(0x0f);
+    auto high = _mm512_and_si512(_mm512_srli_epi16(vector, 4), nibbles);
+    auto low = _mm512_and_si512(vector, nibbles);
+    members = _mm512_test_epi8_mask(_mm512_shuffle_epi8(_mm512_broadcast_i32x4(set), low),
+                                    _mm512_shuffle_epi8(_mm512_broadcast_i32x4(setBits()), high));
+    auto invalid = _mm512_movepi8_mask(_mm512_or_si512(vector, _mm512_add_epi8(blocks, blocks)));
+    return invalid & ~delimiters;
+}
+
+#else
+
+/**
+ * Classifies 64 characters at once, see classify() without AVX2.
+ */
+inline uint64_t classify(const char *chars, char delimiter, __m128i set, uint64_t &delimiters,
+                         uint64_t &members) {
+    auto nibbles = _mm256_set1_epi8(0x0f);
+    auto lows = _mm256_broadcastsi128_si256(lowClasses());
+    auto highs = _mm256_broadcastsi128_si256(highClasses());
+    auto sets = _mm256_broadcastsi128_si256(set);
+    auto bits = _mm256_broadcastsi128_si256(setBits());
+    uint64_t invalid = 0;
+    delimiters = 0;
+    members = 0;
+    for (int i = 0; i < 64; i += 32) {
+        auto vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(chars + i));
+        auto high = _mm256_and_si256(_mm256_srli_epi16(vector, 4), nibbles);
+        auto low = _mm256_and_si256(vector, nibbles);
+        auto classes =
+            _mm256_and_si256(_mm256_shuffle_epi8(lows, low), _mm256_shuffle_epi8(highs, high));
+        auto ends = _mm256_cmpeq_epi8(vector, _mm256_set1_epi8(delimiter));
+        auto wrong = _mm256_andnot_si256(ends, _mm256_cmpeq_epi8(classes, _mm256_setzero_si256()));
+        auto in = _mm256_and_si256(_mm256_shuffle_epi8(sets, low), _mm256_shuffle_epi8(bits, high));
+        auto out = _mm256_cmpeq_epi8(in, _mm256_setzero_si256());
+        invalid |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(wrong))) << i;
+        delimiters |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ends)))
+                      << i;
+        members |= static_cast<uint64_t>(static_cast<uint32_t>(~_mm256_movemask_epi8(out))) << i;
+    }
+    return invalid;
+}
+
+#endif // SAN_X86_AVX512
+
+#endif // SAN_X86_AVX2
+
+} // namespace x86
+} // namespace SAN_KERNEL
+
+namespace x86 = SAN_KERNEL::x86;
+
+} // namespace san
+
+#endif // __SSSE3__
+
+#endif // SAN_X86_H
@@ -1,6 +1,19 @@
+#include <cstdio>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <san.h>
+
+// the exit code of a skipped run, which CTest reports as skipped, see CMakeLists.txt
+constexpr int SKIPPED = 77;
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    // --kernel=<name> runs the tests with that kernel, if the CPU supports it
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--kernel=", 9) == 0 && !san::useKernel(argv[i] + 9)) {
+            printf("kernel %s not supported, skipping\n", argv[i] + 9);
+            return SKIPPED;
+        }
+    }
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Values of mixed magnitude, so the encodings have all lengths.
+ */
+std::vector<int64_t> mixedValues(size_t count) {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(count);
+    for (auto &value : values) {
+        value = static_cast<int64_t>(random() >> random() % 64);
+        if (random() & 1) {
+            value = ~value;
+        }
+    }
+    return values;
+}
+
+/**
+ * Encodes the first n values as a batch and compares each encoding to the one of the
+ * single value encoder, and that nothing is written beyond n * maxLength(bitSize).
+ */
+template <typename T, typename Batch, typename Single>
+void compare(const std::vector<T> &values, size_t bitSize, Batch &&batch, Single &&single) {
+    for (size_t n = 0; n <= values.size(); n += n < 40 ? 1 : 97) {
+        std::string out(n * maxLength(bitSize) + 16, '#');
+        std::vector<uint32_t> offsets(n + 1);
+        auto end = batch(values.data(), n, &out[0], offsets.data());
+        ASSERT_EQ(0, offsets[0]);
+        ASSERT_EQ(&out[0] + offsets[n], end);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(single(values[i]), out.substr(offsets[i], offsets[i + 1] - offsets[i]))
+                << n << " " << i;
+        }
+        ASSERT_EQ(std::string(16, '#'), out.substr(n * maxLength(bitSize))) << n;
+    }
+}
+
+} // namespace
+
+TEST(testBatch, encode32) {
+    auto mixed = mixedValues(1000);
+    std::vector<int32_t> values(mixed.begin(), mixed.end());
+    compare(values, 32, [](auto... args) { return encodeBatch32(args...); },
+            [](int32_t value) { return encode32Signed(value); });
+
+    std::vector<uint32_t> unsignedValues(mixed.begin(), mixed.end());
+    compare(unsignedValues, 32, [](auto... args) { return encodeBatch32(args...); },
+            [](uint32_t value) { return encode32(value); });
+}
+
+TEST(testBatch, encode48) {
+    auto values = mixedValues(1000);
+    compare(values, 48, [](auto... args) { return encodeBatch48(args...); },
+            [](int64_t value) { return encode48Signed(value); });
+}
+
+TEST(testBatch, encode64) {
+    auto values = mixedValues(1000);
+    values.insert(values.end(), {0, -1, INT64_MAX, INT64_MIN, 63, -64});
+    compare(values, 64, [](auto... args) { return encodeBatch64(args...); },
+            [](int64_t value) { return encode64Signed(value); });
+}
+
+TEST(testBatch, encode128) {
+    auto mixed = mixedValues(1000);
+    std::vector<std::pair<int64_t, int64_t>> values;
+    for (size_t i = 0; i < mixed.size(); ++i) {
+        // also values, whose most significant half is just the sign
+        auto ab = i % 3 ? mixed[i] : mixed[(i + 1) % mixed.size()] >> 63;
+        values.emplace_back(ab, mixed[(i + 1) % mixed.size()]);
+    }
+    compare(values, 128, [](auto... args) { return encodeBatch128(args...); },
+            [](const std::pair<int64_t, int64_t> &value) {
+                return encode128Signed(value.first, value.second);
+            });
+}
+
+namespace {
+
+/**
+ * Joins the encodings of the values with the delimiter.
+ */
+template <typename T, typename Single>
+std::string join(const std::vector<T> &values, char delimiter, Single &&single) {
+    std::string buffer;
+    for (const auto &value : values) {
+        buffer += single(value);
+        buffer += delimiter;
+    }
+    if (!buffer.empty()) {
+        buffer.pop_back();
+    }
+    return buffer;
+}
+
+} // namespace
+
+TEST(testBatch, decode32) {
+    auto mixed = mixedValues(1000);
+    std::vector<uint32_t> values(mixed.begin(), mixed.end());
+    auto buffer = join(values, ',', [](uint32_t value) { return encode32(value); });
+    std::vector<uint32_t> out(values.size());
+    auto res = decodeBatch32(buffer.data(), buffer.size(), ',', out.data());
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(buffer.data() + buffer.size(), res.ptr);
+    ASSERT_EQ(values.size(), res.count);
+    ASSERT_EQ(values, out);
+}
+
+TEST(testBatch, decode48) {
+    auto mixed = mixedValues(1000);
+    std::vector<uint64_t> values;
+    for (auto value : mixed) {
+        values.push_back(static_cast<uint64_t>(value) & (1ul << 48) - 1);
+    }
+    auto buffer = join(values, '\n', [](uint64_t value) { return encode48(value); }) + '\n';
+    std::vector<uint64_t> out(values.size());
+    auto res = decodeBatch48(buffer.data(), buffer.size(), '\n', out.data());
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(values.size(), res.count);
+    ASSERT_EQ(values, out);
+}
+
+TEST(testBatch, decode64) {
+    auto mixed = mixedValues(1000);
+    std::vector<uint64_t> values(mixed.begin(), mixed.end());
+    for (size_t n = 0; n <= values.size(); n += n < 40 ? 1 : 97) {
+        std::vector<uint64_t> prefix(values.begin(), values.begin() + n);
+        auto buffer = join(prefix, ' ', [](uint64_t value) { return encode64(value); });
+        std::vector<uint64_t> out(n);
+        auto res = decodeBatch64(buffer.data(), buffer.size(), ' ', out.data());
+        ASSERT_EQ(ERROR::OK, res.ec) << n;
+        ASSERT_EQ(n, res.count);
+        ASSERT_EQ(prefix, out);
+    }
+}
+
+TEST(testBatch, decode128) {
+    auto mixed = mixedValues(1000);
+    std::vector<std::pair<uint64_t, uint64_t>> values;
+    for (size_t i = 0; i < mixed.size(); ++i) {
+        auto ab = i % 3 ? mixed[i] : mixed[(i + 1) % mixed.size()] >> 63;
+        values.emplace_back(ab, mixed[(i + 1) % mixed.size()]);
+    }
+    auto buffer = join(values, ',', [](const std::pair<uint64_t, uint64_t> &value) {
+        return encode128(value.first, value.second);
+    });
+    std::vector<std::pair<uint64_t, uint64_t>> out(values.size());
+    auto res = decodeBatch128(buffer.data(), buffer.size(), ',', out.data());
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(values.size(), res.count);
+    ASSERT_EQ(values, out);
+}
+
+TEST(testBatch, decodeErrors) {
+    const std::vector<std::string> malformed = {
+        "", "a b", "\x80", "ab\xff", "a$", "aaaaaaaaaaaa", "M----------", "aaaaaaaaaaaaaaaaaaaa"};
+    auto mixed = mixedValues(20);
+    std::vector<uint64_t> values(mixed.begin(), mixed.end());
+    for (const auto &token : malformed) {
+        for (size_t at = 0; at <= values.size(); ++at) {
+            // the malformed token after `at` valid ones
+            std::vector<uint64_t> before(values.begin(), values.begin() + at);
+            auto buffer = join(before, ',', [](uint64_t value) { return encode64(value); });
+            auto offset = buffer.size() + (at ? 1 : 0);
+            buffer += (at ? "," : "") + token + ",aqz+";
+
+            std::vector<uint64_t> out(values.size() + 2);
+            auto res = decodeBatch64(buffer.data(), buffer.size(), ',', out.data());
+            uint64_t single;
+            auto expected = decode64(buffer.data() + offset,
+                                     buffer.data() + offset + token.size(), single);
+            ASSERT_EQ(expected.ec, res.ec) << token << " " << at;
+            ASSERT_EQ(expected.ptr, res.ptr) << token << " " << at;
+            ASSERT_EQ(at, res.count);
+            ASSERT_EQ(before, std::vector<uint64_t>(out.begin(), out.begin() + at));
+        }
+    }
+}
+
+TEST(testBatch, decodeDelimiters) {
+    uint32_t out[4];
+    ASSERT_EQ(0, decodeBatch32("", 0, ',', out).count);
+    ASSERT_EQ(ERROR::EMPTY, decodeBatch32(",", 1, ',', out).ec);
+    ASSERT_EQ(ERROR::EMPTY, decodeBatch32("a,,b", 4, ',', out).ec);
+    auto res = decodeBatch32("a,b,", 4, ',', out);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(2, res.count);
+    ASSERT_EQ(ERROR::EMPTY, decodeBatch32("a,b,,", 5, ',', out).ec);
+}
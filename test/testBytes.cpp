@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <sanCodec.h>
+#include <string>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Random big-endian integers of the given size, with runs of leading 0s or 1s bytes.
+ */
+std::vector<std::vector<uint8_t>> integers(size_t n) {
+    std::mt19937_64 random(n);
+    std::vector<std::vector<uint8_t>> res(1000, std::vector<uint8_t>(n));
+    for (auto &bytes : res) {
+        auto leading = random() % (n + 1);
+        auto fill = static_cast<uint8_t>(random() & 1 ? 0xff : 0);
+        for (size_t i = 0; i < n; ++i) {
+            bytes[i] = i < leading ? fill : static_cast<uint8_t>(random());
+        }
+    }
+    return res;
+}
+
+/**
+ * The value of at most 16 big-endian bytes, sign-extended.
+ */
+__int128 toInt(const std::vector<uint8_t> &bytes) {
+    unsigned __int128 res = bytes[0] & 0x80 ? ~static_cast<unsigned __int128>(0) : 0;
+    for (auto byte : bytes) {
+        res = res << 8 | byte;
+    }
+    return static_cast<__int128>(res);
+}
+
+template <size_t... Bytes> void testAsCodec(std::index_sequence<Bytes...>) {
+    (
+        [] {
+            constexpr size_t n = Bytes + 1;
+            for (const auto &bytes : integers(n)) {
+                auto value = static_cast<value_t<8 * n, true>>(toInt(bytes));
+                ASSERT_EQ((encode<8 * n, true>(value)), encodeBytes(bytes.data(), n)) << n;
+            }
+        }(),
+        ...);
+}
+
+} // namespace
+
+TEST(testBytes, asFixedWidths) {
+    for (const auto &bytes : integers(16)) {
+        auto value = toInt(bytes);
+        ASSERT_EQ(encode128Signed(value), encodeBytes(bytes.data(), 16));
+    }
+    for (const auto &bytes : integers(8)) {
+        auto value = static_cast<int64_t>(toInt(bytes));
+        ASSERT_EQ(encode64Signed(value), encodeBytes(bytes.data(), 8));
+    }
+    for (const auto &bytes : integers(6)) {
+        auto value = static_cast<int64_t>(toInt(bytes));
+        ASSERT_EQ(encode48Signed(value), encodeBytes(bytes.data(), 6));
+    }
+    for (const auto &bytes : integers(3)) {
+        auto value = static_cast<int32_t>(toInt(bytes));
+        ASSERT_EQ(encode24Signed(value), encodeBytes(bytes.data(), 3));
+    }
+}
+
+TEST(testBytes, asAnyWidth) { testAsCodec(std::make_index_sequence<16>()); }
+
+TEST(testBytes, roundTrip) {
+    for (size_t n : {1, 2, 5, 7, 16, 17, 20, 24, 32, 33, 64}) {
+        for (auto bytes : integers(n)) {
+            auto encoded = encodeBytes(bytes.data(), n);
+            ASSERT_EQ(encodeBytesLength(bytes.data(), n), encoded.size());
+            ASSERT_LE(encoded.size(), maxLength(8 * n));
+            ASSERT_EQ(ERROR::OK, valid(encoded, 8 * n)) << encoded;
+
+            std::vector<uint8_t> decoded(n, 42);
+            auto res = decodeBytes(encoded.data(), encoded.data() + encoded.size(),
+                                   decoded.data(), n);
+            ASSERT_EQ(ERROR::OK, res.ec) << encoded;
+            ASSERT_EQ(encoded.data() + encoded.size(), res.ptr);
+            ASSERT_EQ(bytes, decoded) << encoded;
+
+            std::reverse(bytes.begin(), bytes.end());
+            ASSERT_EQ(encoded, encodeBytes(bytes.data(), n, ENDIAN::LITTLE));
+            res = decodeBytes(encoded.data(), encoded.data() + encoded.size(), decoded.data(),
+                              n, ENDIAN::LITTLE);
+            ASSERT_EQ(ERROR::OK, res.ec) << encoded;
+            ASSERT_EQ(bytes, decoded) << encoded;
+        }
+    }
+}
+
+TEST(testBytes, sparse) {
+    std::vector<uint8_t> digest(32, 0);
+    ASSERT_EQ("+", encodeBytes(digest.data(), digest.size()));
+    digest.back() = 1;
+    ASSERT_EQ("1", encodeBytes(digest.data(), digest.size()));
+    std::fill(digest.begin(), digest.end(), 0xff);
+    ASSERT_EQ("-", encodeBytes(digest.data(), digest.size()));
+    digest[0] = 0x7f;
+    ASSERT_EQ(maxLength(256), encodeBytesLength(digest.data(), digest.size()));
+    ASSERT_EQ("7" + std::string(maxLength(256) - 1, '-'), encodeBytes(digest.data(), 32));
+
+    // the length is exact, nothing behind the encoding is written
+    char buffer[4] = {'x', 'x', 'x', 'x'};
+    digest.assign(20, 0);
+    digest.back() = 64;
+    ASSERT_EQ(buffer + 2, encodeBytes(digest.data(), digest.size(), buffer));
+    ASSERT_EQ("1+xx", std::string(buffer, 4));
+}
+
+TEST(testBytes, errors) {
+    std::vector<uint8_t> out(20, 42);
+    const std::vector<uint8_t> untouched = out;
+    const std::vector<std::string> inputs = {"", "a!", "\x80", std::string(maxLength(160) + 1, 'a'),
+                                             "g" + std::string(maxLength(160) - 1, 'a')};
+    for (const auto &input : inputs) {
+        auto res = decodeBytes(input.data(), input.data() + input.size(), out.data(), 20);
+        ASSERT_EQ(valid(input, 160), res.ec) << input;
+        ASSERT_NE(ERROR::OK, res.ec) << input;
+        ASSERT_EQ(untouched, out) << input;
+    }
+}
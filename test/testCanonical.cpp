@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <sanCodec.h>
+#include <string>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+static_assert(canonicalize("++a") == "a" && canonicalize("--Z") == "-Z");
+static_assert(canonicalize("+-") == "+-" && canonicalize("-+") == "-+");
+static_assert(canonicalize("+++") == "+" && canonicalize("---") == "-");
+static_assert(isCanonical<64>("a") && !isCanonical<64>("+a") && !isCanonical<64>("a!"));
+static_assert(isCanonical<32>("0+++++") && !isCanonical<24>("+aaaa"));
+
+/**
+ * Tokens of mixed magnitude and sign, some with redundant leading blocks, and some of them
+ * longer than a chunk of 64 characters.
+ */
+std::vector<std::string> tokens(std::mt19937_64 &random, size_t count) {
+    std::vector<std::string> res(count);
+    for (auto &token : res) {
+        auto value = static_cast<int64_t>(random() >> random() % 64);
+        token = encode64Signed(random() & 1 ? ~value : value);
+        auto fill = token[0] == '-' ? '-' : '+';
+        switch (random() % 4) {
+        case 0:
+            token.insert(0, random() % 8, fill);
+            break;
+        case 1:
+            token.insert(0, random() % 80, fill);
+            break;
+        case 2:
+            token = random() & 1 ? "" : std::string(random() % 70 + 1, random() & 1 ? '+' : '-');
+            break;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(testCanonical, likeEncoders) {
+    std::mt19937_64 random(42);
+    for (const auto &token : tokens(random, 10000)) {
+        if (token.empty() || token.size() > maxLength(64)) {
+            continue;
+        }
+        auto canonical = canonicalize(token);
+        ASSERT_EQ(decode64(token), decode64(canonical)) << token;
+        ASSERT_EQ(encode64(decode64(token)), canonical) << token;
+        ASSERT_TRUE(isCanonical<64>(canonical)) << token;
+        ASSERT_EQ(canonical == token, isCanonical<64>(token)) << token;
+    }
+}
+
+TEST(testCanonical, batchLikeTokens) {
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 2000; ++i) {
+        std::string buffer;
+        std::string expected;
+        for (const auto &token : tokens(random, random() % 40)) {
+            buffer += token + '\n';
+            expected += std::string(canonicalize(token)) + '\n';
+        }
+        if (random() & 1 && !buffer.empty()) {
+            buffer.pop_back();
+            expected.pop_back();
+        }
+        auto length = canonicalizeBatch(buffer.data(), buffer.size(), '\n');
+        ASSERT_EQ(expected, buffer.substr(0, length)) << i;
+    }
+}
+
+TEST(testCanonical, batchAcrossChunks) {
+    // runs of redundant blocks, which start before and end after (or at) a chunk boundary
+    for (size_t start = 50; start < 64; ++start) {
+        for (size_t run : {1, 13, 14, 15, 64, 79, 130}) {
+            for (auto token : {std::string("a"), std::string("-"), std::string("-Z")}) {
+                auto fill = token[0] == '-' ? '-' : '+';
+                auto buffer = std::string(start - 1, 'b') + '\n' + std::string(run, fill) +
+                              token + "\n++-\n" + std::string(70, 'c');
+                auto expected = std::string(start - 1, 'b') + '\n' + token + "\n+-\n" +
+                                std::string(70, 'c');
+                auto length = canonicalizeBatch(buffer.data(), buffer.size(), '\n');
+                ASSERT_EQ(expected, buffer.substr(0, length)) << start << " " << run;
+            }
+        }
+    }
+}
+
+TEST(testCanonical, everyKernel) {
+    // buffers of several chunks, whose redundant blocks often cross chunk boundaries
+    std::string active = activeKernel();
+    for (auto name : {"scalar", "sse42", "avx2", "avx512", "native"}) {
+        if (!useKernel(name)) {
+            continue;
+        }
+        std::mt19937_64 random(42);
+        for (int i = 0; i < 500; ++i) {
+            std::string buffer;
+            std::string expected;
+            for (const auto &token : tokens(random, random() % 30 + 70)) {
+                buffer += token + ',';
+                expected += std::string(canonicalize(token)) + ',';
+            }
+            ASSERT_GT(buffer.size(), 64u);
+            auto length = canonicalizeBatch(buffer.data(), buffer.size(), ',');
+            ASSERT_EQ(expected, buffer.substr(0, length)) << name << " " << i;
+        }
+    }
+    useKernel(active.c_str());
+}
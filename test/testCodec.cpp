@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <sanCodec.h>
+#include <string>
+
+using namespace san;
+
+namespace {
+
+// the default alphabet, but another type, so it takes the generated tables
+struct copied_alphabet {
+    static constexpr char chars[65] =
+        "+123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0-";
+};
+
+// safe in URLs and file names, with '0' for 0s and '_' for 1s blocks
+struct url_alphabet {
+    static constexpr char chars[65] =
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_";
+};
+
+using copied = basic_codec<copied_alphabet>;
+using url = basic_codec<url_alphabet>;
+
+static_assert(url::dec['0'] == 0 && url::dec['_'] == 63 && url::dec['+'] == 64);
+static_assert(url::contains('-') && !url::contains('+') && !url::contains('\x80'));
+static_assert(!isAlphabet("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-0"));
+static_assert(!isAlphabet("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz \n"));
+
+/**
+ * Values of mixed magnitude and sign, i.e., of all encoding lengths.
+ */
+std::vector<int64_t> values() {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(10000);
+    for (auto &value : values) {
+        value = static_cast<int64_t>(random() >> random() % 64);
+        value = random() & 1 ? ~value : value;
+    }
+    return values;
+}
+
+/**
+ * Translates an encoding of the default alphabet into the given one.
+ */
+template <typename Alphabet> std::string translate(const std::string &encoded) {
+    std::string res;
+    for (auto c : encoded) {
+        res += Alphabet::chars[codec::dec[static_cast<uint8_t>(c)]];
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(testCodec, defaultIsLibrary) {
+    for (auto value : values()) {
+        ASSERT_EQ(encode64Signed(value), codec::encode64Signed(value));
+        ASSERT_EQ(encode128Signed(value, ~value), codec::encode128Signed(value, ~value));
+        ASSERT_EQ(decode48(encode48(value)), codec::decode48(encode48(value)));
+    }
+}
+
+TEST(testCodec, generatedTablesAsLibrary) {
+    for (auto value : values()) {
+        auto small = static_cast<int32_t>(value);
+        ASSERT_EQ(encode24Signed(small), copied::encode24Signed(small)) << value;
+        ASSERT_EQ(encode32Signed(small), copied::encode32Signed(small)) << value;
+        ASSERT_EQ(encode48Signed(value), copied::encode48Signed(value)) << value;
+        ASSERT_EQ(encode64Signed(value), copied::encode64Signed(value)) << value;
+        ASSERT_EQ(encode128Signed(value, ~value), copied::encode128Signed(value, ~value));
+
+        auto encoded = encode64Signed(value);
+        ASSERT_EQ(decode24(encoded), copied::decode24(encoded)) << encoded;
+        ASSERT_EQ(decode32(encoded), copied::decode32(encoded)) << encoded;
+        ASSERT_EQ(decode48(encoded), copied::decode48(encoded)) << encoded;
+        ASSERT_EQ(decode64(encoded), copied::decode64(encoded)) << encoded;
+        ASSERT_EQ(decode128(encoded), copied::decode128(encoded)) << encoded;
+    }
+}
+
+TEST(testCodec, generatedTablesValidateAsLibrary) {
+    std::mt19937_64 random(42);
+    const std::string chars = std::string(codec::enc) + "@/ \x80";
+    for (int i = 0; i < 100000; ++i) {
+        std::string input(random() % 24, ' ');
+        for (auto &c : input) {
+            c = chars[random() % (random() % 8 ? 64 : chars.size())];
+        }
+        for (size_t bits : {0, 24, 32, 48, 64, 128}) {
+            ASSERT_EQ(valid(input, bits), copied::valid(input, bits)) << input << " " << bits;
+        }
+        auto first = input.data();
+        auto last = first + input.size();
+        uint32_t expected32 = 1, actual32 = 1;
+        auto expected = decode24(first, last, expected32);
+        auto actual = copied::decode24(first, last, actual32);
+        ASSERT_EQ(expected.ec, actual.ec) << input;
+        ASSERT_EQ(expected.ptr, actual.ptr) << input;
+        ASSERT_EQ(expected32, actual32) << input;
+        std::pair<uint64_t, uint64_t> expected128{1, 1}, actual128{1, 1};
+        expected = decode128(first, last, expected128);
+        actual = copied::decode128(first, last, actual128);
+        ASSERT_EQ(expected.ec, actual.ec) << input;
+        ASSERT_EQ(expected.ptr, actual.ptr) << input;
+        ASSERT_EQ(expected128, actual128) << input;
+    }
+}
+
+TEST(testCodec, customAlphabet) {
+    for (auto value : values()) {
+        auto encoded = url::encode64Signed(value);
+        ASSERT_EQ(translate<url_alphabet>(encode64Signed(value)), encoded) << value;
+        ASSERT_EQ(static_cast<uint64_t>(value), url::decode64(encoded)) << encoded;
+        uint64_t decoded;
+        ASSERT_EQ(ERROR::OK, url::decode64(encoded.data(), encoded.data() + encoded.size(),
+                                           decoded).ec);
+        ASSERT_EQ(static_cast<uint64_t>(value), decoded) << encoded;
+
+        encoded = url::encode128Signed(value, value);
+        ASSERT_EQ(translate<url_alphabet>(encode128Signed(value, value)), encoded) << value;
+    }
+    ASSERT_EQ("0", url::encode32(0));
+    ASSERT_EQ("_", url::encode32(~0u));
+    ASSERT_EQ("0_", url::encode32(63));
+    ASSERT_EQ(ERROR::WRONG_CHAR, url::valid("a+b"));
+    ASSERT_EQ(ERROR::TOO_LONG, url::valid("W0000", 24));
+}
+
+TEST(testCodec, noSpace) {
+    char buffer[3];
+    auto res = url::encode64(buffer, buffer + sizeof(buffer), 1ul << 20);
+    ASSERT_EQ(ERROR::NO_SPACE, res.ec);
+    ASSERT_EQ(buffer + sizeof(buffer), res.ptr);
+    res = url::encode64(buffer, buffer + sizeof(buffer), 1ul << 11);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(buffer + 2, res.ptr);
+}
+
+TEST(testCodec, keepsTheRest) {
+    std::string buffer(maxLength(128), '.');
+    auto res = url::encode64(&buffer[0], &buffer[0] + buffer.size(), 1ul << 11);
+    ASSERT_EQ(&buffer[2], res.ptr);
+    ASSERT_EQ("W0" + std::string(buffer.size() - 2, '.'), buffer);
+}
+
+namespace {
+
+/**
+ * Encodes and decodes values of all lengths with the given width, which encodes like the
+ * library, but is at most maxLength(Bits) characters long.
+ */
+template <size_t Bits> void testWidth() {
+    std::mt19937_64 random(Bits);
+    for (int i = 0; i < 100; ++i) {
+        auto high = static_cast<int64_t>(random() >> random() % 64);
+        auto low = static_cast<int64_t>(random() >> random() % 64);
+        auto value = static_cast<value_t<Bits, true>>(random() & 1 ? ~low : low);
+        std::string expected;
+        if constexpr (Bits <= 64) {
+            auto extended = static_cast<int64_t>(static_cast<uint64_t>(value) << (64 - Bits)) >>
+                            (64 - Bits);
+            expected = encode64Signed(extended);
+        } else {
+            auto extended = static_cast<__int128>(static_cast<unsigned __int128>(high) << 64 |
+                                                  static_cast<uint64_t>(low))
+                                << (128 - Bits) >>
+                            (128 - Bits);
+            expected = encode128Signed(static_cast<int64_t>(extended >> 64),
+                                       static_cast<int64_t>(extended));
+            value = static_cast<value_t<Bits, true>>(extended);
+        }
+        if (expected.size() > maxLength(Bits)) {
+            expected.erase(0, expected.size() - maxLength(Bits));
+        }
+
+        auto encoded = encode<Bits, true>(value);
+        ASSERT_EQ(expected, encoded) << Bits << " " << expected;
+        ASSERT_EQ(encoded, encode<Bits>(static_cast<value_t<Bits>>(value))) << Bits;
+        ASSERT_EQ(ERROR::OK, valid<Bits>(encoded)) << Bits << " " << encoded;
+
+        auto unsignedValue = static_cast<value_t<Bits>>(value);
+        if constexpr (Bits % (sizeof(unsignedValue) * 8)) {
+            unsignedValue &= (value_t<Bits>{1} << Bits) - 1;
+        }
+        ASSERT_TRUE(unsignedValue == decode<Bits>(encoded)) << Bits << " " << encoded;
+        value_t<Bits> decoded{};
+        ASSERT_EQ(ERROR::OK, decode<Bits>(encoded.data(), encoded.data() + encoded.size(),
+                                          decoded)
+                                 .ec);
+        ASSERT_TRUE(unsignedValue == decoded) << Bits << " " << encoded;
+    }
+
+    auto tooLong = std::string(maxLength(Bits) + 1, '1');
+    ASSERT_EQ(ERROR::TOO_LONG, valid<Bits>(tooLong)) << Bits;
+    ASSERT_EQ(valid(tooLong.substr(1), Bits), valid<Bits>(tooLong.substr(1))) << Bits;
+}
+
+template <size_t... Bits> void testWidths(std::index_sequence<Bits...>) {
+    (testWidth<Bits + 1>(), ...);
+}
+
+static_assert(std::is_same<value_t<16>, uint16_t>::value);
+static_assert(std::is_same<value_t<40, true>, int64_t>::value);
+static_assert(std::is_same<value_t<96>, unsigned __int128>::value);
+static_assert(valid<16>("1----") == ERROR::TOO_LONG && valid<17>("1--") == ERROR::OK);
+static_assert(decode<16>("1--") == 0x1fff && decode<16>("-") == 0xffff);
+
+} // namespace
+
+TEST(testCodec, anyWidth) { testWidths(std::make_index_sequence<128>()); }
+
+TEST(testCodec, anyWidthAsLibrary) {
+    for (auto value : values()) {
+        auto small = static_cast<int32_t>(value);
+        ASSERT_EQ(encode24Signed(small), (encode<24, true>(small))) << value;
+        ASSERT_EQ(encode32(small), encode<32>(small)) << value;
+        ASSERT_EQ(encode48Signed(value), (encode<48, true>(value))) << value;
+        ASSERT_EQ(encode64(value), encode<64>(value)) << value;
+        ASSERT_EQ(encode128Signed(value, ~value),
+                  (encode<128, true>(static_cast<__int128>(value) << 64 |
+                                     static_cast<uint64_t>(~value))));
+
+        auto encoded = encode64Signed(value);
+        ASSERT_EQ(decode24(encoded), decode<24>(encoded)) << encoded;
+        ASSERT_EQ(decode48(encoded), decode<48>(encoded)) << encoded;
+        ASSERT_EQ(decode64(encoded), decode<64>(encoded)) << encoded;
+        auto expected = decode128(encoded);
+        ASSERT_TRUE((static_cast<unsigned __int128>(expected.first) << 64 | expected.second) ==
+                    decode<128>(encoded))
+            << encoded;
+    }
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <string>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Values of mixed magnitude and sign, i.e., of all encoding lengths, with repetitions.
+ */
+std::vector<int64_t> values() {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(2000);
+    for (auto &value : values) {
+        value = static_cast<int64_t>(random() >> random() % 64);
+        value = random() & 1 ? ~value : value;
+    }
+    for (size_t i = 0; i < values.size(); i += 10) {
+        values[i] = values[random() % values.size()];
+    }
+    return values;
+}
+
+/**
+ * Prepends blocks of the leading fill, which valid() accepts up to the maximum length.
+ */
+std::string padded(std::string encoded, size_t bitSize) {
+    auto fill = encoded[0] == '-' ? '-' : '+';
+    auto size = encoded.size() + encoded.size() % 3;
+    if (size < maxLength(bitSize)) {
+        encoded.insert(0, size - encoded.size(), fill);
+    }
+    return encoded;
+}
+
+template <typename T> int sign(T a, T b) { return a < b ? -1 : a > b ? 1 : 0; }
+
+} // namespace
+
+TEST(testCompare, likeDecoded) {
+    auto numbers = values();
+    for (size_t i = 1; i < numbers.size(); ++i) {
+        auto a = numbers[i - 1];
+        auto b = numbers[i];
+        auto x = encode64Signed(a);
+        auto y = padded(encode64Signed(b), 64);
+        ASSERT_EQ(ERROR::OK, valid(y, 64)) << y;
+        ASSERT_EQ(sign(a, b), sign(compare64(x, y), 0)) << x << " " << y;
+        ASSERT_EQ(sign(b, a), sign(compare64(y, x), 0)) << x << " " << y;
+
+        auto a32 = static_cast<int32_t>(a);
+        auto b32 = static_cast<int32_t>(b);
+        ASSERT_EQ(sign(a32, b32), sign(compare32(encode32Signed(a32), encode32(b32)), 0));
+        auto a24 = static_cast<int32_t>(static_cast<uint32_t>(a) << 8) >> 8;
+        auto b24 = static_cast<int32_t>(static_cast<uint32_t>(b) << 8) >> 8;
+        ASSERT_EQ(sign(a24, b24), sign(compare24(encode24(a24), encode24(b24)), 0));
+        auto a48 = a << 16 >> 16;
+        auto b48 = b << 16 >> 16;
+        ASSERT_EQ(sign(a48, b48), sign(compare48(encode48(a48), encode48(b48)), 0));
+
+        auto wideA = static_cast<__int128>(a) << 64 | static_cast<uint64_t>(b);
+        auto wideB = static_cast<__int128>(b) << 64 | static_cast<uint64_t>(a);
+        x = encode128Signed(wideA);
+        y = padded(encode128Signed(wideB), 128);
+        ASSERT_EQ(ERROR::OK, valid(y, 128)) << y;
+        ASSERT_EQ(sign(wideA, wideB), sign(compare128(x, y), 0)) << x << " " << y;
+        ASSERT_EQ(0, compare128(x, padded(x, 128))) << x;
+    }
+}
+
+TEST(testCompare, edgeCases) {
+    ASSERT_EQ(0, compare64("++a", "a"));
+    ASSERT_EQ(0, compare64("--Z", "-Z"));
+    ASSERT_EQ(0, compare64("+", "++"));
+    ASSERT_GT(compare64("+-", "-"), 0);
+    ASSERT_LT(compare64("-", "+"), 0);
+    ASSERT_LT(compare64("a", "A"), 0);
+    ASSERT_LT(compare64("Z", "1+"), 0);
+    ASSERT_GT(compare64("-Z", "-1+"), 0);
+    ASSERT_LT(compare32("0+++++", "-"), 0);
+    ASSERT_GT(compare32("1-----", "0+++++"), 0);
+    ASSERT_LT(compare24("W+++", "+"), 0);
+    ASSERT_EQ(0, compare128("", "+"));
+    ASSERT_LT(compare128(encode128(1ul << 63, 0), encode128(~0ul, 0)), 0);
+}
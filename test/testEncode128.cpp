@@ -259,3 +259,28 @@ TEST(testEncode128, allPatternsValid) {
         ASSERT_EQ(ERROR::OK, valid(encode128Signed(input.first, input.second), 128));
     }
 }
+
+TEST(testEncode128, nativeAsPairs) {
+    for (auto uns : patterns) {
+        auto native = static_cast<unsigned __int128>(uns.first) << 64 | uns.second;
+        std::string encoded = encode128(uns.first, uns.second);
+        ASSERT_EQ(encoded, encode128(native));
+        ASSERT_EQ(encoded, encode128Signed(static_cast<__int128>(native)));
+        ASSERT_TRUE(native == decode128Native(encoded)) << encoded;
+        ASSERT_TRUE(static_cast<__int128>(native) == decode128NativeSigned(encoded)) << encoded;
+
+        __int128 decoded = 0;
+        auto res = decode128Signed(encoded.data(), encoded.data() + encoded.size(), decoded);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_TRUE(static_cast<__int128>(native) == decoded) << encoded;
+    }
+
+    char buffer[maxLength(128)];
+    auto res = encode128(buffer, buffer + 1, ~static_cast<unsigned __int128>(0) >> 1);
+    ASSERT_EQ(ERROR::NO_SPACE, res.ec);
+    std::string tooLong(maxLength(128) + 1, 'a');
+    unsigned __int128 decoded = 42;
+    auto error = decode128(tooLong.data(), tooLong.data() + tooLong.size(), decoded);
+    ASSERT_EQ(ERROR::TOO_LONG, error.ec);
+    ASSERT_TRUE(decoded == 42);
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <sanEncoded.h>
+#include <unordered_set>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+constexpr auto PORT = encodeInline<16>(8080);
+static_assert(PORT.view() == "10g" && PORT.decode() == 8080);
+static_assert(encodeInline<32, true>(-1).view() == "-");
+static_assert(Encoded<48>().empty() && Encoded<48>() < encodeInline<48>(0));
+
+} // namespace
+
+TEST(testEncoded, asStrings) {
+    std::mt19937_64 random(42);
+    std::vector<Encoded<64>> keys;
+    std::vector<std::string> strings;
+    for (int i = 0; i < 10000; ++i) {
+        auto value = random() >> random() % 64;
+        keys.push_back(encodeInline<64>(value));
+        strings.push_back(encode64(value));
+        ASSERT_EQ(strings.back(), keys.back().view());
+        ASSERT_EQ(strings.back(), keys.back().str());
+        ASSERT_EQ(value, keys.back().decode());
+        ASSERT_EQ(encode128Signed(static_cast<__int128>(value) << 64),
+                  encodeInline<128>(static_cast<unsigned __int128>(value) << 64).view());
+    }
+
+    std::sort(keys.begin(), keys.end());
+    std::sort(strings.begin(), strings.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(strings[i], keys[i].view());
+        if (i) {
+            ASSERT_EQ(strings[i - 1] == strings[i], keys[i - 1] == keys[i]);
+            ASSERT_EQ(strings[i - 1] != strings[i], keys[i - 1] != keys[i]);
+            ASSERT_TRUE(keys[i - 1] <= keys[i] && keys[i] >= keys[i - 1]);
+            ASSERT_EQ(strings[i - 1] < strings[i], keys[i] > keys[i - 1]);
+        }
+    }
+
+    std::unordered_set<Encoded<64>> set(keys.begin(), keys.end());
+    ASSERT_EQ(std::unordered_set<std::string>(strings.begin(), strings.end()).size(), set.size());
+    ASSERT_EQ(std::hash<std::string_view>()(strings[0]), std::hash<Encoded<64>>()(keys[0]));
+}
+
+TEST(testEncoded, fromChars) {
+    Encoded<24> encoded = encodeInline<24>(42);
+    auto res = from_chars(std::string_view("aqz+"), encoded);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ("aqz+", encoded.view());
+    ASSERT_EQ(decode24("aqz+"), encoded.decode());
+
+    for (std::string input : {"", "a!", "aqz++", "\x80"}) {
+        res = from_chars(input, encoded);
+        ASSERT_EQ(valid(input, 24), res.ec) << input;
+        ASSERT_EQ("aqz+", encoded.view()) << input;
+    }
+}
+
+TEST(testEncoded, increment) {
+    auto encoded = encodeInline<64>(0);
+    for (uint64_t value = 1; value < 10000; ++value) {
+        increment(encoded);
+        ASSERT_EQ(encode64(value), encoded.view());
+    }
+    for (int64_t start : {-1l, -2l, -64l, -65l, -4097l, INT64_MAX, INT64_MIN}) {
+        encoded = encodeInline<64, true>(start);
+        ++encoded;
+        ASSERT_EQ(encode64Signed(static_cast<int64_t>(static_cast<uint64_t>(start) + 1)),
+                  encoded.view())
+            << start;
+    }
+    auto narrow = encodeInline<24>(0xffffff);
+    ASSERT_EQ(encode24(0), (++narrow).view());
+}
+
+TEST(testEncoded, encodeRange) {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> starts = {0, -1, 61, 62, 63, 64, 4030, 4095, -64, -65, -4096, -4160};
+    for (auto shift : {12, 18, 30, 60}) {
+        starts.push_back((1l << shift) - 100);
+        starts.push_back(-(1l << shift) - 100);
+    }
+    starts.push_back(INT64_MAX - 100);
+    starts.push_back(INT64_MIN);
+    for (int i = 0; i < 100; ++i) {
+        starts.push_back(static_cast<int64_t>(random() >> random() % 64));
+    }
+
+    std::vector<Encoded<64>> encoded(300);
+    for (auto start : starts) {
+        encodeRange<64, true>(start, encoded.size(), encoded.data());
+        for (size_t i = 0; i < encoded.size(); ++i) {
+            auto value = static_cast<int64_t>(static_cast<uint64_t>(start) + i);
+            ASSERT_EQ(encode64Signed(value), encoded[i].view()) << start << " " << i;
+        }
+    }
+
+    std::vector<Encoded<24>> narrow(300);
+    for (int32_t start : {0, -150, 0x7fffff - 150, 0xffffff - 150, 0x3f000 - 150}) {
+        encodeRange<24, true>(start, narrow.size(), narrow.data());
+        for (size_t i = 0; i < narrow.size(); ++i) {
+            auto value = static_cast<uint32_t>(start) + static_cast<uint32_t>(i);
+            ASSERT_EQ(encode24(value & 0xffffff), narrow[i].view()) << start << " " << i;
+        }
+    }
+
+    std::vector<Encoded<6>> tiny(300);
+    encodeRange<6>(60, tiny.size(), tiny.data());
+    for (size_t i = 0; i < tiny.size(); ++i) {
+        ASSERT_EQ((encodeInline<6>((60 + i) & 0x3f)), tiny[i]) << i;
+    }
+
+    std::vector<Encoded<128>> wide(300);
+    for (auto high : {0ul, ~0ul, 1ul << 63, (1ul << 63) - 1}) {
+        auto start = static_cast<unsigned __int128>(high) << 64 | (~0ul - 150);
+        encodeRange<128>(start, wide.size(), wide.data());
+        for (size_t i = 0; i < wide.size(); ++i) {
+            auto value = static_cast<__int128>(start + i);
+            ASSERT_EQ(encode128Signed(value), wide[i].view()) << high << " " << i;
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <san.h>
+#include <tables.h>
+#include <vector>
+
+using namespace san;
+
+const std::vector<int64_t> values = { // NOLINT(cert-err58-cpp)
+    0,          1,           62,          63,         64,          -1,
+    -2,         -64,         -65,         0x123456,   0x7fffff,    -0x800000,
+    0x7fffffff, -0x80000000, 0x123456789, 0xc4c4c4c4c4c4, INT64_MAX, INT64_MIN};
+
+TEST(testFromChars, sameAsUnchecked) {
+    for (auto value : values) {
+        std::string encoded = encode24(static_cast<uint32_t>(value));
+        uint32_t out32 = 0;
+        auto res = decode24(encoded.data(), encoded.data() + encoded.size(), out32);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encoded.data() + encoded.size(), res.ptr);
+        ASSERT_EQ(decode24(encoded), out32);
+
+        int32_t signed32 = 0;
+        res = decode24Signed(encoded.data(), encoded.data() + encoded.size(), signed32);
+        ASSERT_EQ(decode24Signed(encoded), signed32);
+
+        encoded = encode32(static_cast<uint32_t>(value));
+        res = from_chars(encoded, out32);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(static_cast<uint32_t>(value), out32);
+        res = from_chars(encoded, signed32);
+        ASSERT_EQ(static_cast<int32_t>(value), signed32);
+
+        encoded = encode48(value);
+        uint64_t out64 = 0;
+        res = decode48(encoded.data(), encoded.data() + encoded.size(), out64);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(decode48(encoded), out64);
+
+        int64_t signed64 = 0;
+        res = decode48Signed(encoded.data(), encoded.data() + encoded.size(), signed64);
+        ASSERT_EQ(decode48Signed(encoded), signed64);
+
+        encoded = encode64(value);
+        res = from_chars(encoded, out64);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(static_cast<uint64_t>(value), out64);
+        res = from_chars(encoded, signed64);
+        ASSERT_EQ(value, signed64);
+
+        encoded = encode128Signed(value, ~value);
+        std::pair<int64_t, int64_t> out128;
+        res = from_chars(encoded, out128);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(std::make_pair(value, ~value), out128);
+        __int128 native128;
+        res = from_chars(encoded, native128);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_TRUE((static_cast<__int128>(value) << 64 | static_cast<uint64_t>(~value)) ==
+                    native128);
+    }
+}
+
+TEST(testFromChars, sameErrorsAsValid) {
+    const std::vector<std::string> inputs = {"",         "+",         "a",        "a b",
+                                             "\x80",     "ab\xff",    "a$",       "++++++",
+                                             "-+++++",   "0+++++",    "2+++++",   "+++++++",
+                                             "1-----",   "a---------", "f----------",
+                                             "M----------", "----------------------"};
+    for (const auto &input : inputs) {
+        const char *first = input.data();
+        const char *last = first + input.size();
+        uint32_t out32 = 42;
+        auto res = decode32(first, last, out32);
+        ASSERT_EQ(valid(input, 32), res.ec) << input;
+        if (res.ec != ERROR::OK) {
+            ASSERT_EQ(42, out32) << input;
+        }
+        uint64_t out64 = 42;
+        ASSERT_EQ(valid(input, 24), decode24(first, last, out32).ec) << input;
+        ASSERT_EQ(valid(input, 48), decode48(first, last, out64).ec) << input;
+        ASSERT_EQ(valid(input, 64), decode64(first, last, out64).ec) << input;
+        std::pair<uint64_t, uint64_t> out128;
+        ASSERT_EQ(valid(input, 128), decode128(first, last, out128).ec) << input;
+    }
+}
+
+TEST(testFromChars, errorPositions) {
+    std::string input = "ab$c";
+    uint64_t out = 0;
+    auto res = from_chars(input, out);
+    ASSERT_EQ(ERROR::WRONG_CHAR, res.ec);
+    ASSERT_EQ(input.data() + 2, res.ptr);
+
+    input = "abc\xe4";
+    res = from_chars(input, out);
+    ASSERT_EQ(ERROR::HIGH_BIT, res.ec);
+    ASSERT_EQ(input.data() + 3, res.ptr);
+
+    input = "";
+    res = from_chars(input, out);
+    ASSERT_EQ(ERROR::EMPTY, res.ec);
+    ASSERT_EQ(input.data(), res.ptr);
+
+    input = "abcdefghijkl";
+    res = from_chars(input, out);
+    ASSERT_EQ(ERROR::TOO_LONG, res.ec);
+    ASSERT_EQ(input.data() + maxLength(64), res.ptr);
+
+    input = "abcdefghijk";
+    res = from_chars(input, out);
+    ASSERT_EQ(ERROR::TOO_LONG, res.ec);
+    ASSERT_EQ(input.data(), res.ptr);
+}
+
+TEST(testFromChars, slices) {
+    const char *line = "aqz+,1aqz+,-aqz+";
+    uint32_t out = 0;
+    auto res = decode32(line, line + 4, out);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(decode32("aqz+"), out);
+    res = from_chars(std::string_view(line + 5, 5), out);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(decode32("1aqz+"), out);
+    res = from_chars(line + 11, line + 16, out);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(decode32("-aqz+"), out);
+}
+
+TEST(testFromChars, uncheckedEmpty) {
+    ASSERT_EQ(0, decode24(""));
+    ASSERT_EQ(0, decode32(""));
+    ASSERT_EQ(0, decode48(""));
+    ASSERT_EQ(0, decode64(""));
+    ASSERT_EQ(std::make_pair(uint64_t{0}, uint64_t{0}), decode128(""));
+}
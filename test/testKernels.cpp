@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <string>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Encodes values of all lengths and decodes them again, as one string.
+ */
+std::string roundTrips() {
+    std::mt19937_64 random(42);
+    std::string res;
+    for (int i = 0; i < 1000; ++i) {
+        auto value = random() >> random() % 64;
+        auto encoded = encode64(value) + encode128(value, ~value) + encode32(value);
+        res += encoded + std::to_string(decode64(encode64(value))) + ',';
+        res += std::to_string(static_cast<int>(valid(encoded.substr(0, 12), 64))) + ',';
+        res += std::to_string(compare128(encode128(value, ~value), encode128(~value, value)));
+        auto padded = std::string(value % 70, '+') + encode64(value) + ',' + encoded;
+        res.append(padded.data(), canonicalizeBatch(padded.data(), padded.size(), ','));
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(testKernels, active) {
+    std::string active = activeKernel();
+    ASSERT_FALSE(active.empty());
+    ASSERT_FALSE(useKernel("unknown"));
+    ASSERT_EQ(active, activeKernel());
+    ASSERT_TRUE(useKernel(active.c_str()));
+}
+
+TEST(testKernels, sameResults) {
+    std::string active = activeKernel();
+    auto expected = roundTrips();
+    for (auto name : {"scalar", "sse42", "avx2", "avx512", "native"}) {
+        if (useKernel(name)) {
+            ASSERT_EQ(name, std::string(activeKernel()));
+            ASSERT_EQ(expected, roundTrips()) << name;
+        }
+    }
+    useKernel(active.c_str());
+}
@@ -0,0 +1,67 @@
+// the inline codec, which is compared with the library here
+#define SAN_HEADER_ONLY
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sanCodec.h>
+
+using namespace san;
+using namespace san::literals;
+
+namespace {
+
+static_assert("aqz+"_san32 == 0x29a8c0);
+static_assert("4zhmu9+i"_san48 == 0x123456789012);
+static_assert("-"_san24 == 0xffffff && "-"_san32 == ~0u && "-"_san64 == ~0ul);
+static_assert("1-----"_san32 == 0x7fffffffu && "0+++++"_san32 == 0x80000000u);
+static_assert("1+"_san128 == std::pair<uint64_t, uint64_t>{0, 64});
+static_assert("-+"_san128 == std::pair<uint64_t, uint64_t>{~0ul, ~0ul << 6});
+
+static_assert(codec::valid("4zhmu9+i", 48) == ERROR::OK);
+static_assert(codec::valid("W0000", 24) == ERROR::TOO_LONG);
+static_assert(codec::valid("a!") == ERROR::WRONG_CHAR);
+static_assert(codec::decode64("-Mo") == static_cast<uint64_t>(-1000));
+
+/**
+ * Encodes at compile time.
+ */
+constexpr std::pair<std::array<char, maxLength(64)>, size_t> encoded(int64_t value) {
+    std::array<char, maxLength(64)> buffer{};
+    auto res = codec::encode64Signed(buffer.data(), buffer.data() + buffer.size(), value);
+    return {buffer, static_cast<size_t>(res.ptr - buffer.data())};
+}
+
+constexpr auto MINUS_1000 = encoded(-1000);
+static_assert(MINUS_1000.second == 3 && MINUS_1000.first[0] == '-' &&
+              MINUS_1000.first[1] == 'M' && MINUS_1000.first[2] == 'o');
+
+} // namespace
+
+TEST(testLiterals, literals) {
+    EXPECT_EQ(decode32("aqz+"), "aqz+"_san32);
+    EXPECT_EQ(decode48("4zhmu9+i"), "4zhmu9+i"_san48);
+    EXPECT_EQ(decode64("-Mo"), "-Mo"_san64);
+    EXPECT_EQ(decode24("-Mo"), "-Mo"_san24);
+    EXPECT_EQ(decode128("1+"), "1+"_san128);
+}
+
+TEST(testLiterals, headerOnlyAsLibrary) {
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 10000; ++i) {
+        auto value = static_cast<int64_t>(random() >> random() % 64);
+        value = random() & 1 ? ~value : value;
+        auto small = static_cast<int32_t>(value);
+        ASSERT_EQ(encode24Signed(small), codec::encode24Signed(small)) << value;
+        ASSERT_EQ(encode32Signed(small), codec::encode32Signed(small)) << value;
+        ASSERT_EQ(encode48Signed(value), codec::encode48Signed(value)) << value;
+        ASSERT_EQ(encode64Signed(value), codec::encode64Signed(value)) << value;
+        ASSERT_EQ(encode128Signed(value, ~value), codec::encode128Signed(value, ~value));
+
+        auto encoded = encode64Signed(value);
+        ASSERT_EQ(decode24(encoded), codec::decode24(encoded)) << encoded;
+        ASSERT_EQ(decode48(encoded), codec::decode48(encoded)) << encoded;
+        ASSERT_EQ(decode64(encoded), codec::decode64(encoded)) << encoded;
+        ASSERT_EQ(decode128(encoded), codec::decode128(encoded)) << encoded;
+        ASSERT_EQ(valid(encoded, 32), codec::valid(encoded, 32)) << encoded;
+    }
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <san.h>
+#include <sanOrdered.h>
+#include <string>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+static_assert(decodeOrdered<64, true>("A-") == 0 && decodeOrdered<64, true>("9_") == -27);
+static_assert(decodeOrdered<64>("10--") == 1 << 12);
+static_assert(validOrdered<13, true>("40--") == ERROR::TOO_LONG);
+static_assert(validOrdered<13, true>("3zz") == ERROR::OK);
+static_assert(validOrdered<24, true>("-1---") == ERROR::TOO_LONG);
+static_assert(validOrdered<24, true>("6z---") == ERROR::TOO_LONG);
+static_assert(validOrdered<24, true>("6V---") == ERROR::TOO_LONG);
+static_assert(validOrdered<24, true>("6U---") == ERROR::OK);
+static_assert(validOrdered<24, true>("-V---") == ERROR::OK);
+static_assert(validOrdered<48, true>("-1-------") == ERROR::TOO_LONG);
+static_assert(validOrdered<24>("2z---") == ERROR::OK);
+
+/**
+ * Values of mixed magnitude and sign of the given width, i.e., of all encoding lengths.
+ */
+template <size_t Bits, bool Signed> std::vector<value_t<Bits, Signed>> values() {
+    std::mt19937_64 random(Bits);
+    std::vector<value_t<Bits, Signed>> values(5000);
+    for (auto &value : values) {
+        auto high = static_cast<unsigned __int128>(random() >> random() % 64);
+        auto low = random() >> random() % 64;
+        auto wide = random() & 1 ? high << 64 | low : low;
+        if constexpr (Signed) {
+            wide = random() & 1 ? ~wide : wide;
+            if constexpr (Bits < 128) {
+                wide = static_cast<unsigned __int128>(static_cast<__int128>(wide << (128 - Bits)) >>
+                                                      (128 - Bits));
+            }
+        } else if constexpr (Bits < 128) {
+            wide &= (static_cast<unsigned __int128>(1) << Bits) - 1;
+        }
+        value = static_cast<value_t<Bits, Signed>>(wide);
+    }
+    return values;
+}
+
+/**
+ * Sorts values and their encodings, which must be in the same order, and decodes them.
+ */
+template <size_t Bits, bool Signed> void testWidth() {
+    auto numbers = values<Bits, Signed>();
+    std::sort(numbers.begin(), numbers.end());
+    std::vector<std::string> encoded;
+    for (auto value : numbers) {
+        encoded.push_back(encodeOrdered<Bits, Signed>(value));
+    }
+    ASSERT_TRUE(std::is_sorted(encoded.begin(), encoded.end())) << Bits;
+
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        auto &input = encoded[i];
+        ASSERT_LE(input.size(), (ordered_codec<Bits, Signed>::maxLength())) << Bits;
+        ASSERT_EQ(ERROR::OK, (validOrdered<Bits, Signed>(input))) << Bits << " " << input;
+        ASSERT_TRUE(numbers[i] == (decodeOrdered<Bits, Signed>(input))) << Bits << " " << input;
+        value_t<Bits, Signed> decoded{};
+        auto res =
+            decodeOrdered<Bits, Signed>(input.data(), input.data() + input.size(), decoded);
+        ASSERT_EQ(ERROR::OK, res.ec) << Bits << " " << input;
+        ASSERT_EQ(input.data() + input.size(), res.ptr) << Bits << " " << input;
+        ASSERT_TRUE(numbers[i] == decoded) << Bits << " " << input;
+        if (i && numbers[i] != numbers[i - 1]) {
+            ASSERT_LT(encoded[i - 1], encoded[i]) << Bits;
+        }
+    }
+}
+
+} // namespace
+
+TEST(testOrdered, sortsLikeValues) {
+    testWidth<24, false>();
+    testWidth<24, true>();
+    testWidth<32, false>();
+    testWidth<32, true>();
+    testWidth<48, false>();
+    testWidth<48, true>();
+    testWidth<64, false>();
+    testWidth<64, true>();
+    testWidth<128, false>();
+    testWidth<128, true>();
+    testWidth<1, true>();
+    testWidth<7, false>();
+    testWidth<13, true>();
+    testWidth<100, true>();
+}
+
+TEST(testOrdered, atMostOneLonger) {
+    for (auto value : values<64, true>()) {
+        ASSERT_LE((encodeOrdered<64, true>(value).size()), encode64Signed(value).size() + 1);
+        ASSERT_LE((encodeOrdered<48, true>(value).size()), encode48Signed(value).size() + 1);
+    }
+    for (auto value : values<128, true>()) {
+        ASSERT_LE((encodeOrdered<128, true>(value).size()), encode128Signed(value).size() + 1);
+    }
+}
+
+TEST(testOrdered, extremes) {
+    ASSERT_TRUE(std::is_sorted(ordered_alphabet::chars, ordered_alphabet::chars + 64));
+    ASSERT_EQ("-s----------", (encodeOrdered<64, true>(INT64_MIN)));
+    ASSERT_EQ("K6zzzzzzzzzz", (encodeOrdered<64, true>(INT64_MAX)));
+    ASSERT_EQ("9z", (encodeOrdered<64, true>(-1)));
+    ASSERT_EQ("A-", (encodeOrdered<64, true>(0)));
+    ASSERT_EQ("--", encodeOrdered<64>(0));
+    ASSERT_EQ("9Ezzzzzzzzzz", encodeOrdered<64>(~0ul));
+    ASSERT_EQ("42zzzzz", encodeOrdered<32>(~0u));
+}
+
+TEST(testOrdered, valid) {
+    ASSERT_EQ(ERROR::EMPTY, (validOrdered<64, true>("")));
+    ASSERT_EQ(ERROR::WRONG_CHAR, (validOrdered<64, true>("A+")));
+    ASSERT_EQ(ERROR::HIGH_BIT, (validOrdered<64, true>("A\x80")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("M0")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("A00")));
+    ASSERT_EQ(ERROR::TOO_SHORT, (validOrdered<64, true>("B0")));
+    ASSERT_EQ(ERROR::TOO_SHORT, (validOrdered<64, true>("A")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("B-1")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("8z-")));
+    ASSERT_EQ(ERROR::OK, (validOrdered<64, true>("8y-")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("K7----------")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64, true>("-r----------")));
+    ASSERT_EQ(ERROR::OK, (validOrdered<64, true>("-s----------")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64>("B0")));
+    ASSERT_EQ(ERROR::TOO_LONG, (validOrdered<64>("9F----------")));
+    ASSERT_EQ(ERROR::OK, (validOrdered<24>("2zzzz")));
+
+    std::string input = "A0-";
+    int64_t decoded = 7;
+    auto res = decodeOrdered<64, true>(input.data(), input.data() + input.size(), decoded);
+    ASSERT_EQ(ERROR::TOO_LONG, res.ec);
+    ASSERT_EQ(input.data() + 2, res.ptr);
+    ASSERT_EQ(7, decoded);
+    res = decodeOrdered<64, true>(input.data(), input.data() + 2, decoded);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(1, decoded);
+}
+
+TEST(testOrdered, noSpace) {
+    char buffer[3];
+    auto res = encodeOrdered<64>(buffer, buffer + sizeof(buffer), 1ul << 20);
+    ASSERT_EQ(ERROR::NO_SPACE, res.ec);
+    ASSERT_EQ(buffer + sizeof(buffer), res.ptr);
+    res = encodeOrdered<64>(buffer, buffer + sizeof(buffer), 1ul << 11);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(buffer + 3, res.ptr);
+}
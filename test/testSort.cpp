@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <san.h>
+#include <sanEncoded.h>
+#include <sanSort.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace san;
+
+namespace {
+
+/**
+ * Values of mixed magnitude and sign, with many duplicates, and their encodings, of which
+ * some have redundant leading blocks, e.g., "++a" for "a".
+ */
+template <size_t Bits, bool Signed>
+std::vector<std::string> tokens(size_t count, std::vector<value_t<Bits, Signed>> &values) {
+    std::mt19937_64 random(count + Bits);
+    values.resize(count);
+    std::vector<std::string> res(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i && random() % 4 == 0) {
+            values[i] = values[random() % i];
+        } else {
+            auto high = static_cast<unsigned __int128>(random() >> random() % 64);
+            auto wide = Bits > 64 && random() & 1 ? high << 64 | random() : high;
+            wide = random() & 1 ? ~wide : wide;
+            if constexpr (Signed && Bits < 128) {
+                wide = static_cast<unsigned __int128>(static_cast<__int128>(wide << (128 - Bits)) >>
+                                                      (128 - Bits));
+            } else if constexpr (Bits < 128) {
+                wide &= (static_cast<unsigned __int128>(1) << Bits) - 1;
+            }
+            values[i] = static_cast<value_t<Bits, Signed>>(wide);
+        }
+        auto token = encode<Bits, Signed>(values[i]);
+        if (random() % 3 == 0) {
+            auto padding = random() % (maxLength(Bits) - token.size() + 1);
+            token.insert(0, padding, token[0] == '-' ? '-' : '+');
+        }
+        res[i] = token;
+    }
+    return res;
+}
+
+/**
+ * Sorts the tokens and their values, by std::stable_sort of the values, and compares the
+ * orders, with and without duplicates.
+ */
+template <size_t Bits, bool Signed> void testSort(size_t count, size_t threads = 0) {
+    std::vector<value_t<Bits, Signed>> values;
+    auto input = tokens<Bits, Signed>(count, values);
+    std::vector<size_t> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&](size_t a, size_t b) { return values[a] < values[b]; });
+    ASSERT_EQ(expected, (sortEncodedIndex<Bits, Signed>(input, false, threads)))
+        << Bits << " " << count;
+
+    auto last = std::unique(expected.begin(), expected.end(),
+                            [&](size_t a, size_t b) { return values[a] == values[b]; });
+    expected.erase(last, expected.end());
+    ASSERT_EQ(expected, (sortEncodedIndex<Bits, Signed>(input, true, threads)))
+        << Bits << " " << count;
+
+    auto sorted = input;
+    sortEncoded<Bits, Signed>(sorted, true, threads);
+    ASSERT_EQ(expected.size(), sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        ASSERT_EQ(input[expected[i]], sorted[i]) << Bits << " " << i;
+    }
+}
+
+} // namespace
+
+TEST(testSort, likeStdSort) {
+    for (size_t count : {0, 1, 2, 100, 10000}) {
+        testSort<64, false>(count);
+        testSort<64, true>(count);
+        testSort<128, false>(count);
+        testSort<128, true>(count);
+        testSort<24, true>(count);
+        testSort<48, false>(count);
+    }
+}
+
+TEST(testSort, inParallel) {
+    // also slices of a single entry, or none
+    for (size_t threads : {2, 3, 8}) {
+        testSort<64, true>(5, threads);
+        testSort<64, false>(10000, threads);
+        testSort<128, true>(10000, threads);
+    }
+    testSort<64, true>(radix::PARALLEL * 2);
+}
+
+TEST(testSort, redundantBlocks) {
+    std::vector<std::string> input = {"++a", "-", "a", "+-", "--Z", "+", "-Z", "+++"};
+    auto order = sortEncodedIndex<64, true>(input);
+    ASSERT_EQ((std::vector<size_t>{4, 6, 1, 5, 7, 0, 2, 3}), order);
+    order = sortEncodedIndex<64, false>(input, true);
+    ASSERT_EQ((std::vector<size_t>{5, 0, 3, 4, 1}), order);
+}
+
+TEST(testSort, views) {
+    std::string column = "++a -Z + --Z a";
+    std::vector<std::string_view> input = {{column.data(), 3},
+                                           {column.data() + 4, 2},
+                                           {column.data() + 7, 1},
+                                           {column.data() + 9, 3},
+                                           {column.data() + 13, 1}};
+    ASSERT_EQ((std::vector<size_t>{1, 3, 2, 0, 4}), (sortEncodedIndex<64, true>(input)));
+    sortEncoded<64, true>(input, true);
+    ASSERT_EQ((std::vector<std::string_view>{"-Z", "+", "++a"}), input);
+
+    Encoded<64> encoded[] = {encodeInline<64, true>(1), encodeInline<64, true>(-1)};
+    ASSERT_EQ((std::vector<size_t>{1, 0}), (sortEncodedIndex<64, true>(encoded)));
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <san.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace san;
+
+#ifdef SAN_STATS
+
+TEST(testStats, encode) {
+    resetStats();
+    encode32(0);
+    encode32(63);
+    encode32Signed(-2);
+    encode64(~0ul);
+    char buffer[2];
+    encode64(buffer, buffer + sizeof(buffer), 1ul << 40);
+
+    auto res = collectStats();
+    EXPECT_EQ(3, res.widths[1].encodes);
+    EXPECT_EQ(1, res.widths[1].lengths[1]);
+    EXPECT_EQ(2, res.widths[1].lengths[2]);
+    EXPECT_EQ(1, res.widths[1].extraPlus);
+    EXPECT_EQ(1, res.widths[1].extraMinus);
+    EXPECT_EQ(2, res.widths[3].encodes);
+    EXPECT_EQ(1, res.widths[3].lengths[1]);
+    EXPECT_EQ(0, res.widths[3].extraMinus);
+    EXPECT_EQ(1, res.errors[static_cast<size_t>(ERROR::NO_SPACE)]);
+}
+
+TEST(testStats, batch) {
+    std::vector<int64_t> values{0, 63, -2, 1000};
+    std::vector<char> out(values.size() * maxLength(48));
+    std::vector<uint32_t> offsets(values.size() + 1);
+    resetStats();
+    encodeBatch48(values.data(), values.size(), out.data(), offsets.data());
+
+    auto res = collectStats();
+    EXPECT_EQ(4, res.widths[2].encodes);
+    EXPECT_EQ(1, res.widths[2].lengths[1]);
+    EXPECT_EQ(3, res.widths[2].lengths[2]);
+    EXPECT_EQ(1, res.widths[2].extraPlus);
+    EXPECT_EQ(1, res.widths[2].extraMinus);
+}
+
+TEST(testStats, decode) {
+    std::string buffer = "a\nb\n!\nc";
+    uint64_t out[4];
+    resetStats();
+    decode24("abc");
+    decode128(encode128(1, 2));
+    decodeBatch64(buffer.data(), buffer.size(), '\n', out);
+    EXPECT_EQ(ERROR::WRONG_CHAR, valid("a!"));
+    EXPECT_EQ(ERROR::TOO_LONG, valid("aaaaa", 24));
+    EXPECT_EQ(ERROR::OK, valid("a"));
+    std::vector<from_chars_result> errors;
+    EXPECT_EQ(4, validBatch(buffer.data(), buffer.size(), '\n', 0, errors));
+
+    auto res = collectStats();
+    EXPECT_EQ(1, res.widths[0].decodes);
+    EXPECT_EQ(1, res.widths[4].decodes);
+    EXPECT_EQ(3, res.widths[3].decodes);
+    EXPECT_EQ(7, res.validations);
+    EXPECT_EQ(3, res.errors[static_cast<size_t>(ERROR::WRONG_CHAR)]);
+    EXPECT_EQ(1, res.errors[static_cast<size_t>(ERROR::TOO_LONG)]);
+    EXPECT_EQ(0, res.errors[static_cast<size_t>(ERROR::OK)]);
+}
+
+TEST(testStats, otherFunctions) {
+    std::string buffer = "+1\n-Z";
+    uint8_t bytes[2] = {1, 2};
+    resetStats();
+    canonicalizeBatch(&buffer[0], buffer.size(), '\n');
+    auto encoded = encodeBytes(bytes, sizeof(bytes));
+    decodeBytes(encoded.data(), encoded.data() + encoded.size(), bytes, sizeof(bytes));
+    std::string wrong = "a!";
+    decodeBytes(wrong.data(), wrong.data() + wrong.size(), bytes, sizeof(bytes));
+    compare64("a", "b");
+    compare64("a", "a");
+    compare128("a", "b");
+
+    auto res = collectStats();
+    EXPECT_EQ(1, res.canonicalizations);
+    EXPECT_EQ(1, res.byteEncodes);
+    EXPECT_EQ(2, res.byteDecodes);
+    EXPECT_EQ(1, res.errors[static_cast<size_t>(ERROR::WRONG_CHAR)]);
+    EXPECT_EQ(2, res.widths[3].compares);
+    EXPECT_EQ(1, res.widths[4].compares);
+    EXPECT_EQ(0, res.widths[3].decodes);
+}
+
+TEST(testStats, threads) {
+    resetStats();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([] {
+            for (int j = 0; j < 1000; ++j) {
+                decode48(encode48(j));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    encode48(0);
+
+    auto res = collectStats();
+    EXPECT_EQ(4001, res.widths[2].encodes);
+    EXPECT_EQ(4000, res.widths[2].decodes);
+
+    auto twice = res;
+    twice += res;
+    EXPECT_EQ(8002, twice.widths[2].encodes);
+    EXPECT_EQ(2 * res.widths[2].lengths[2], twice.widths[2].lengths[2]);
+}
+
+#else
+
+TEST(testStats, disabled) {
+    encode32(0);
+    decode32("+");
+    EXPECT_EQ(ERROR::EMPTY, valid(""));
+
+    auto res = collectStats();
+    EXPECT_EQ(0, res.widths[1].encodes);
+    EXPECT_EQ(0, res.widths[1].decodes);
+    EXPECT_EQ(0, res.validations);
+    EXPECT_EQ(0, res.errors[static_cast<size_t>(ERROR::EMPTY)]);
+}
+
+#endif
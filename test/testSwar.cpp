@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <swar.h>
+#include <tables.h>
+
+using namespace san;
+
+TEST(testSwar, loadPartial) {
+    const char *input = "abcdefgh";
+    for (size_t n = 1; n <= 8; ++n) {
+        uint64_t expected = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expected = expected << 8 | static_cast<uint8_t>(input[i]);
+        }
+        ASSERT_EQ(expected, swar::load(input, n)) << n;
+    }
+}
+
+TEST(testSwar, decodeAllBytes) {
+    for (int c = 0; c < 256; ++c) {
+        char byte = static_cast<char>(c);
+        uint64_t value;
+        auto invalid = swar::decode(&byte, 1, value);
+        if (c < 128 && dec[c] < 64) {
+            ASSERT_EQ(0, invalid) << c;
+            ASSERT_EQ(static_cast<uint64_t>(dec[c]), value) << c;
+        } else {
+            ASSERT_NE(0, invalid) << c;
+            ASSERT_EQ(0, swar::firstInvalid(invalid, 1)) << c;
+        }
+    }
+}
+
+TEST(testSwar, decodeWords) {
+    std::mt19937 random(42);
+    for (size_t round = 0; round < 100000; ++round) {
+        size_t n = random() % 8 + 1;
+        char input[8];
+        uint64_t expected = 0;
+        for (size_t i = 0; i < n; ++i) {
+            input[i] = enc[random() % 64];
+            expected = expected << 6 | static_cast<uint64_t>(dec[static_cast<int>(input[i])]);
+        }
+        uint64_t value;
+        ASSERT_EQ(0, swar::decode(input, n, value));
+        ASSERT_EQ(expected, value);
+
+        // break one character and see it is found
+        size_t broken = random() % n;
+        input[broken] = random() & 1 ? '*' : static_cast<char>(0x80 | random());
+        auto invalid = swar::decode(input, n, value);
+        ASSERT_NE(0, invalid);
+        ASSERT_EQ(broken, swar::firstInvalid(invalid, n));
+    }
+}
@@ -79,3 +79,23 @@ TEST(testTables, bijectionDecodeEncode) {
     }
     ASSERT_EQ(dead, 64);
 }
+
+TEST(testTables, encodePairs) {
+    for (auto i = 0u; i < 4096; ++i) {
+        ASSERT_EQ(enc[i >> 6], encPairs[2 * i]);
+        ASSERT_EQ(enc[i & 0x3f], encPairs[2 * i + 1]);
+    }
+}
+
+TEST(testTables, decodePairs) {
+    auto dead = 0u;
+    for (auto i = 0u; i < 128 * 128; ++i) {
+        if (decPairs[i] >= 4096) {
+            ++dead;
+            ASSERT_TRUE(dec[i >> 7] == '@' || dec[i & 0x7f] == '@');
+        } else {
+            ASSERT_EQ(dec[i >> 7] << 6 | dec[i & 0x7f], decPairs[i]);
+        }
+    }
+    ASSERT_EQ(dead, 128 * 128 - 64 * 64);
+}
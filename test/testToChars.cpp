@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <san.h>
+#include <vector>
+
+using namespace san;
+
+const std::vector<int64_t> values = { // NOLINT(cert-err58-cpp)
+    0,          1,           62,          63,         64,          -1,
+    -2,         -64,         -65,         0x123456,   0x7fffff,    -0x800000,
+    0x7fffffff, -0x80000000, 0x123456789, 0xc4c4c4c4c4c4, INT64_MAX, INT64_MIN};
+
+TEST(testToChars, sameAsString) {
+    char buffer[maxLength(128)];
+    char *last = buffer + sizeof(buffer);
+    for (auto value : values) {
+        auto input32 = static_cast<int32_t>(value);
+        auto res = encode24Signed(buffer, last, input32);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encode24Signed(input32), std::string(buffer, res.ptr));
+        res = encode32Signed(buffer, last, input32);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encode32Signed(input32), std::string(buffer, res.ptr));
+        res = encode48Signed(buffer, last, value);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encode48Signed(value), std::string(buffer, res.ptr));
+        res = encode64Signed(buffer, last, value);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encode64Signed(value), std::string(buffer, res.ptr));
+        res = encode128Signed(buffer, last, value, ~value);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(encode128Signed(value, ~value), std::string(buffer, res.ptr));
+    }
+}
+
+TEST(testToChars, genericOverloads) {
+    char buffer[maxLength(128)];
+    char *last = buffer + sizeof(buffer);
+    for (auto value : values) {
+        auto res = to_chars(buffer, last, static_cast<int32_t>(value));
+        ASSERT_EQ(encode32Signed(static_cast<int32_t>(value)), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, static_cast<uint32_t>(value));
+        ASSERT_EQ(encode32(static_cast<uint32_t>(value)), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, value);
+        ASSERT_EQ(encode64Signed(value), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, static_cast<uint64_t>(value));
+        ASSERT_EQ(encode64(static_cast<uint64_t>(value)), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, std::make_pair(value, value));
+        ASSERT_EQ(encode128Signed(value, value), std::string(buffer, res.ptr));
+        auto uns = static_cast<uint64_t>(value);
+        res = to_chars(buffer, last, std::make_pair(uns, uns));
+        ASSERT_EQ(encode128(uns, uns), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, static_cast<__int128>(value) << 64 | uns);
+        ASSERT_EQ(encode128Signed(value, value), std::string(buffer, res.ptr));
+        res = to_chars(buffer, last, static_cast<unsigned __int128>(uns) << 64 | uns);
+        ASSERT_EQ(encode128(uns, uns), std::string(buffer, res.ptr));
+    }
+}
+
+TEST(testToChars, exactBuffer) {
+    for (auto value : values) {
+        std::string expected = encode64Signed(value);
+        std::vector<char> buffer(expected.size());
+        auto res = encode64Signed(buffer.data(), buffer.data() + buffer.size(), value);
+        ASSERT_EQ(ERROR::OK, res.ec);
+        ASSERT_EQ(buffer.data() + buffer.size(), res.ptr);
+        ASSERT_EQ(expected, std::string(buffer.data(), res.ptr));
+    }
+}
+
+TEST(testToChars, keepsTheRest) {
+    for (auto value : values) {
+        std::string buffer(maxLength(128), '.');
+        auto first = &buffer[0], last = first + buffer.size();
+        auto res = encode24Signed(first, last, static_cast<int32_t>(value));
+        ASSERT_EQ(std::string(last - res.ptr, '.'), std::string(res.ptr, last));
+        res = encode64Signed(first, last, value);
+        ASSERT_EQ(std::string(last - res.ptr, '.'), std::string(res.ptr, last));
+        res = encode128Signed(first, last, value, value);
+        ASSERT_EQ(std::string(last - res.ptr, '.'), std::string(res.ptr, last));
+    }
+}
+
+TEST(testToChars, bufferTooSmall) {
+    for (auto value : values) {
+        std::string expected = encode128Signed(value, value);
+        std::vector<char> buffer(expected.size() - 1);
+        auto res = encode128Signed(buffer.data(), buffer.data() + buffer.size(), value, value);
+        ASSERT_EQ(ERROR::NO_SPACE, res.ec);
+        ASSERT_EQ(buffer.data() + buffer.size(), res.ptr);
+    }
+    char buffer[1];
+    auto res = encode32(buffer, buffer, 0);
+    ASSERT_EQ(ERROR::NO_SPACE, res.ec);
+    ASSERT_EQ(buffer, res.ptr);
+}
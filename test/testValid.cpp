@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <random>
 #include <san.h>
 #include <tables.h>
 
@@ -145,3 +147,123 @@ TEST(testValid, tooLongFirstByte1Bit) {
         }
     }
 }
+
+namespace {
+
+/**
+ * The error valid() reports for the token [first, last), with its position.
+ */
+from_chars_result expected(const char *first, const char *last, size_t bitSize) {
+    if (first == last) {
+        return {first, ERROR::EMPTY};
+    }
+    for (auto at = first; at != last; ++at) {
+        auto byte = static_cast<uint8_t>(*at);
+        if (byte >= 128 || dec[byte] == '@') {
+            return {at, byte >= 128 ? ERROR::HIGH_BIT : ERROR::WRONG_CHAR};
+        }
+    }
+    auto ec = valid(std::string(first, last), bitSize);
+    if (ec == ERROR::OK) {
+        return {last, ec};
+    }
+    auto size = static_cast<size_t>(last - first);
+    return {size > maxLength(bitSize) ? first + maxLength(bitSize) : first, ec};
+}
+
+/**
+ * Tokens of 1-23 random characters, where about one in `rarity` characters is replaced
+ * by a random byte (so also by a delimiter).
+ */
+std::string tokens(size_t length, char delimiter, size_t rarity) {
+    std::mt19937_64 random(7);
+    std::string buffer;
+    while (buffer.size() < length) {
+        auto size = random() % 23 + 1;
+        for (size_t i = 0; i < size; ++i) {
+            buffer += enc[random() % 64];
+        }
+        buffer += delimiter;
+    }
+    for (auto &c : buffer) {
+        if (random() % rarity == 0) {
+            c = static_cast<char>(random());
+        }
+    }
+    return buffer;
+}
+
+} // namespace
+
+TEST(testValid, batch) {
+    for (size_t rarity : {20, 1000, 1000000}) {
+        auto buffer = tokens(100000, '\n', rarity);
+        for (size_t bitSize : {0, 24, 32, 48, 64, 128}) {
+            // the malformed tokens one by one
+            std::vector<from_chars_result> reference;
+            size_t count = 0;
+            for (auto first = buffer.data(), last = first + buffer.size(); first != last;) {
+                auto end = std::find(first, last, '\n');
+                auto result = expected(first, end, bitSize);
+                if (result.ec != ERROR::OK) {
+                    reference.push_back(result);
+                }
+                ++count;
+                first = end == last ? end : end + 1;
+            }
+
+            std::vector<from_chars_result> errors;
+            ASSERT_EQ(count, validBatch(buffer.data(), buffer.size(), '\n', bitSize, errors));
+            ASSERT_EQ(reference.size(), errors.size()) << rarity << " " << bitSize;
+            for (size_t i = 0; i < errors.size(); ++i) {
+                ASSERT_EQ(reference[i].ptr - buffer.data(), errors[i].ptr - buffer.data()) << i;
+                ASSERT_EQ(reference[i].ec, errors[i].ec) << i;
+            }
+
+            auto first = validBatch(buffer.data(), buffer.size(), '\n', bitSize);
+            if (reference.empty()) {
+                ASSERT_EQ(ERROR::OK, first.ec);
+                ASSERT_EQ(buffer.data() + buffer.size(), first.ptr);
+                ASSERT_EQ(count, first.count);
+            } else {
+                ASSERT_EQ(reference[0].ec, first.ec);
+                ASSERT_EQ(reference[0].ptr, first.ptr);
+                auto before = static_cast<size_t>(first.ptr - buffer.data());
+                ASSERT_EQ(std::count(buffer.begin(), buffer.begin() + before, '\n'), first.count);
+            }
+        }
+    }
+}
+
+TEST(testValid, batchFullLength) {
+    // 64-bit values, which mostly have 11 characters, the only ones with a top block check
+    std::mt19937_64 random(42);
+    std::string buffer;
+    for (int i = 0; i < 10000; ++i) {
+        buffer += encode64(random()) + ',';
+    }
+    auto res = validBatch(buffer.data(), buffer.size(), ',', 64);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(10000, res.count);
+
+    auto at = buffer.size() / 2;
+    at = buffer.find(',', at) + 1;
+    buffer.replace(at, 11, "M----------");
+    res = validBatch(buffer.data(), buffer.size(), ',', 64);
+    ASSERT_EQ(ERROR::TOO_LONG, res.ec);
+    ASSERT_EQ(buffer.data() + at, res.ptr);
+    ASSERT_EQ(std::count(buffer.begin(), buffer.begin() + at, ','), res.count);
+}
+
+TEST(testValid, batchDelimiters) {
+    ASSERT_EQ(0, validBatch("", 0, ',').count);
+    ASSERT_EQ(ERROR::EMPTY, validBatch(",", 1, ',').ec);
+    ASSERT_EQ(ERROR::EMPTY, validBatch("a,,b", 4, ',').ec);
+    auto res = validBatch("a,b,", 4, ',');
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(2, res.count);
+    std::string empty(100, ',');
+    std::vector<from_chars_result> errors;
+    ASSERT_EQ(100, validBatch(empty.data(), empty.size(), ',', 0, errors));
+    ASSERT_EQ(100, errors.size());
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <x86.h>
+
+#ifdef SAN_X86
+
+#include <cstdlib>
+#include <san.h>
+#include <tables.h>
+
+using namespace san;
+
+TEST(testX86, toChars) {
+    alignas(16) char blocks[16];
+    alignas(16) char chars[16];
+    for (int first = 0; first < 64; first += 16) {
+        for (int i = 0; i < 16; ++i) {
+            blocks[i] = static_cast<char>(first + i);
+        }
+        auto vector = x86::toChars(_mm_load_si128(reinterpret_cast<const __m128i *>(blocks)));
+        _mm_store_si128(reinterpret_cast<__m128i *>(chars), vector);
+        for (int i = 0; i < 16; ++i) {
+            ASSERT_EQ(enc[first + i], chars[i]) << first + i;
+        }
+    }
+}
+
+TEST(testX86, toBlocks) {
+    alignas(16) char chars[16];
+    alignas(16) char blocks[16];
+    for (int first = 0; first < 256; first += 16) {
+        for (int i = 0; i < 16; ++i) {
+            chars[i] = static_cast<char>(first + i);
+        }
+        __m128i vector;
+        auto invalid =
+            x86::toBlocks(_mm_load_si128(reinterpret_cast<const __m128i *>(chars)), vector);
+        _mm_store_si128(reinterpret_cast<__m128i *>(blocks), vector);
+        for (int i = 0; i < 16; ++i) {
+            int c = first + i;
+            if (c < 128 && dec[c] < 64) {
+                ASSERT_FALSE(invalid & 1u << i) << c;
+                ASSERT_EQ(dec[c], blocks[i]) << c;
+            } else {
+                ASSERT_TRUE(invalid & 1u << i) << c;
+            }
+        }
+    }
+}
+
+TEST(testX86, classify) {
+    char chars[64];
+    unsigned __int128 set = 0;
+    for (auto c : {'+', '0', 'Z', 'a', '\x7f'}) {
+        set |= static_cast<unsigned __int128>(1) << c;
+    }
+    for (int first = 0; first < 256; first += 64) {
+        for (int i = 0; i < 64; ++i) {
+            chars[i] = static_cast<char>(first + i);
+        }
+        uint64_t delimiters;
+        uint64_t members;
+        auto invalid = x86::classify(chars, '\n', x86::toSet(set), delimiters, members);
+        for (int i = 0; i < 64; ++i) {
+            int c = first + i;
+            ASSERT_EQ(c == '\n', (delimiters >> i & 1) != 0) << c;
+            ASSERT_EQ(c < 128 && (set >> c & 1), (members >> i & 1) != 0) << c;
+            ASSERT_EQ(c != '\n' && (c >= 128 || dec[c] == '@'), (invalid >> i & 1) != 0) << c;
+        }
+    }
+}
+
+TEST(testX86, pageStart) {
+    // right at the start of a page, decoding must not load the bytes before it
+    auto page = static_cast<char *>(aligned_alloc(4096, 4096));
+    memcpy(page, "-aqz+", 5);
+    uint32_t out = 0;
+    auto res = decode32(page, page + 5, out);
+    ASSERT_EQ(ERROR::OK, res.ec);
+    ASSERT_EQ(decode32("-aqz+"), out);
+    ASSERT_EQ(-1, decode64Signed(std::string_view(page, 1)));
+    free(page);
+}
+
+#endif // SAN_X86
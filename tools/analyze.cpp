@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <iterator>
+#include <san.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// san-analyze: how many bytes a file of values, one per line, takes in this encoding,
+// compared to the input itself, to fixed-length hexadecimal, to decimal and to base64.
+
+using namespace san;
+
+namespace {
+
+using int128_t = __int128;
+using uint128_t = unsigned __int128;
+
+enum class Type { AUTO, INT, IP, MAC, UUID };
+
+const size_t widths[] = {24, 32, 48, 64, 128};
+
+const char *usage = R"(usage: san-analyze [options] FILE
+
+Reads one value per line from FILE (- for stdin) and reports the bytes its encodings
+would take: this library (and its unsigned variant, which omits leading 0s only), the
+input, fixed-length hexadecimal, decimal, and base64 of the bytes (with and without
+padding), plus a histogram of the encoded lengths, per width.
+
+options:
+  --type=TYPE   auto (the default, per line), int (decimal, or hex with 0x), ip (IPv4,
+                as in memory, i.e., inet_aton's s_addr), mac (48 bit, : or - separated)
+                or uuid (128 bit)
+  --bits=BITS   the width to encode at, 24, 32, 48, 64 or 128, by default 64 for
+                integers, 32 for IPs, 48 for MACs and 128 for UUIDs; values that do not
+                fit (as signed or unsigned values) are skipped
+  --threads=N   the number of threads, by default one per core
+)";
+
+/**
+ * The bytes of every representation of the values of one width.
+ */
+struct Summary {
+    uint64_t values = 0;
+    uint64_t negative = 0;
+    uint64_t san = 0;
+    uint64_t sanUnsigned = 0;
+    uint64_t input = 0;
+    uint64_t hex = 0;
+    uint64_t decimal = 0;
+    uint64_t base64 = 0;
+    uint64_t base64Unpadded = 0;
+    uint64_t lengths[maxLength(128) + 1] = {};
+
+    Summary &operator+=(const Summary &other) {
+        values += other.values;
+        negative += other.negative;
+        san += other.san;
+        sanUnsigned += other.sanUnsigned;
+        input += other.input;
+        hex += other.hex;
+        decimal += other.decimal;
+        base64 += other.base64;
+        base64Unpadded += other.base64Unpadded;
+        for (size_t i = 0; i < std::size(lengths); ++i) {
+            lengths[i] += other.lengths[i];
+        }
+        return *this;
+    }
+};
+
+struct Results {
+    Summary summaries[std::size(widths)];
+    uint64_t skipped = 0;
+
+    Results &operator+=(const Results &other) {
+        for (size_t i = 0; i < std::size(widths); ++i) {
+            summaries[i] += other.summaries[i];
+        }
+        skipped += other.skipped;
+        return *this;
+    }
+};
+
+bool hexByte(const char *first, uint8_t &byte) {
+    return std::from_chars(first, first + 2, byte, 16).ptr == first + 2;
+}
+
+/**
+ * Parses digits of the base into 128 bits, unlike std::from_chars, which stops at 64.
+ *
+ * @return false for no digits, other characters, or more than 128 bits
+ */
+bool parseDigits(const char *first, const char *last, unsigned base, uint128_t &value) {
+    value = 0;
+    for (auto pos = first; pos != last; ++pos) {
+        uint8_t digit = 0;
+        if (std::from_chars(pos, pos + 1, digit, base).ptr != pos + 1 ||
+            value > (~uint128_t() - digit) / base) {
+            return false;
+        }
+        value = value * base + digit;
+    }
+    return first != last;
+}
+
+bool parseInt(std::string_view line, int128_t &value) {
+    auto first = line.data();
+    auto last = first + line.size();
+    uint128_t magnitude = 0;
+    if (line.size() > 2 && line[0] == '0' && (line[1] == 'x' || line[1] == 'X')) {
+        if (!parseDigits(first + 2, last, 16, magnitude)) {
+            return false;
+        }
+    } else if (line[0] == '-') {
+        // down to -2^127
+        if (!parseDigits(first + 1, last, 10, magnitude) || magnitude > uint128_t(1) << 127) {
+            return false;
+        }
+        magnitude = -magnitude;
+    } else if (!parseDigits(first, last, 10, magnitude)) {
+        return false;
+    }
+    value = static_cast<int128_t>(magnitude);
+    return true;
+}
+
+bool parseIp(std::string_view line, int128_t &value) {
+    auto first = line.data();
+    auto last = first + line.size();
+    uint32_t address = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        uint8_t octet;
+        auto res = std::from_chars(first, last, octet);
+        auto end = i < 3 ? res.ptr != last && *res.ptr == '.' : res.ptr == last;
+        if (res.ec != std::errc() || !end) {
+            return false;
+        }
+        address |= static_cast<uint32_t>(octet) << 8 * i;
+        first = res.ptr + 1;
+    }
+    value = address;
+    return true;
+}
+
+bool parseMac(std::string_view line, int128_t &value) {
+    uint64_t mac = 0;
+    for (size_t i = 0; i < 6; ++i) {
+        uint8_t byte = 0;
+        if ((i != 0 && line[3 * i - 1] != line[2]) || !hexByte(line.data() + 3 * i, byte)) {
+            return false;
+        }
+        mac = mac << 8 | byte;
+    }
+    value = mac;
+    return true;
+}
+
+bool parseUuid(std::string_view line, int128_t &value) {
+    uint128_t uuid = 0;
+    for (size_t pos = 0; pos < line.size(); pos += 2) {
+        uint8_t byte = 0;
+        if (pos == 8 || pos == 13 || pos == 18 || pos == 23) {
+            if (line[pos++] != '-') {
+                return false;
+            }
+        }
+        if (!hexByte(line.data() + pos, byte)) {
+            return false;
+        }
+        uuid = uuid << 8 | byte;
+    }
+    value = static_cast<int128_t>(uuid);
+    return true;
+}
+
+Type detect(std::string_view line) {
+    if (line.size() == 36 && line[8] == '-') {
+        return Type::UUID;
+    } else if (line.size() == 17 && (line[2] == ':' || line[2] == '-')) {
+        return Type::MAC;
+    } else if (line.find('.') != std::string_view::npos) {
+        return Type::IP;
+    }
+    return Type::INT;
+}
+
+size_t defaultBits(Type type) {
+    switch (type) {
+    case Type::IP:
+        return 32;
+    case Type::MAC:
+        return 48;
+    case Type::UUID:
+        return 128;
+    default:
+        return 64;
+    }
+}
+
+size_t decimalDigits(uint128_t value) {
+    size_t digits = 1;
+    for (; value >> 64 != 0; value /= 10) {
+        ++digits;
+    }
+    for (auto small = static_cast<uint64_t>(value); small >= 10; small /= 10) {
+        ++digits;
+    }
+    return digits;
+}
+
+size_t significantBits(uint128_t value) {
+    auto high = static_cast<uint64_t>(value >> 64);
+    auto low = static_cast<uint64_t>(value);
+    return high ? 128 - __builtin_clzll(high) : low ? 64 - __builtin_clzll(low) : 0;
+}
+
+/**
+ * Encodes the value with the library, sign-extended from the given width.
+ */
+size_t sanLength(size_t bits, int128_t value) {
+    char buffer[maxLength(128)];
+    auto last = buffer + sizeof(buffer);
+    auto ab = static_cast<int64_t>(value >> 64);
+    auto cd = static_cast<int64_t>(value);
+    to_chars_result res{};
+    switch (bits) {
+    case 24:
+        res = encode24Signed(buffer, last, static_cast<int32_t>(cd));
+        break;
+    case 32:
+        res = encode32Signed(buffer, last, static_cast<int32_t>(cd));
+        break;
+    case 48:
+        res = encode48Signed(buffer, last, cd);
+        break;
+    case 64:
+        res = encode64Signed(buffer, last, cd);
+        break;
+    default:
+        res = encode128Signed(buffer, last, ab, cd);
+    }
+    return static_cast<size_t>(res.ptr - buffer);
+}
+
+/**
+ * Summarizes the lines between first and last.
+ */
+void analyze(const char *first, const char *last, Type type, size_t bits, Results &results) {
+    while (first < last) {
+        auto end = static_cast<const char *>(memchr(first, '\n', last - first));
+        end = end ? end : last;
+        std::string_view line(first, end - first);
+        first = end + 1;
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        auto lineType = type == Type::AUTO ? detect(line) : type;
+        int128_t value = 0;
+        bool parsed;
+        switch (lineType) {
+        case Type::IP:
+            parsed = parseIp(line, value);
+            break;
+        case Type::MAC:
+            parsed = line.size() == 17 && parseMac(line, value);
+            break;
+        case Type::UUID:
+            parsed = line.size() == 36 && parseUuid(line, value);
+            break;
+        default:
+            parsed = parseInt(line, value);
+        }
+        auto width = bits ? bits : defaultBits(lineType);
+        // integers from 2^127 on wrap around, so only 128 bits hold them, as unsigned values
+        auto wrapped = lineType == Type::INT && value < 0 && line[0] != '-';
+        // fits as a signed or an unsigned value of the width, if the line is one at all
+        auto fits = parsed && (width == 128 || (!wrapped && (value >> (width - 1) == 0 ||
+                                                             value >> (width - 1) == -1 ||
+                                                             (value >= 0 && value >> width == 0))));
+        if (!fits) {
+            ++results.skipped;
+            continue;
+        }
+
+        auto &summary = results.summaries[std::find(widths, std::end(widths), width) - widths];
+        auto length = sanLength(width, value);
+        auto mask = width == 128 ? ~uint128_t() : (uint128_t(1) << width) - 1;
+        auto pattern = static_cast<uint128_t>(value) & mask;
+        // only integers have a sign, the top bit of the others is just a bit
+        auto negative = lineType == Type::INT && value < 0 && !wrapped;
+        ++summary.values;
+        summary.negative += negative;
+        summary.san += length;
+        summary.sanUnsigned += std::max<size_t>(1, (significantBits(pattern) + 5) / 6);
+        summary.input += line.size();
+        summary.hex += width / 4;
+        summary.decimal += negative ? decimalDigits(-static_cast<uint128_t>(value)) + 1
+                                     : decimalDigits(pattern);
+        summary.base64 += (width / 8 + 2) / 3 * 4;
+        summary.base64Unpadded += maxLength(width);
+        ++summary.lengths[length];
+    }
+}
+
+/**
+ * Analyzes the buffer with the given number of threads, on chunks split at line ends.
+ */
+Results analyze(const char *buffer, size_t size, Type type, size_t bits, size_t threads) {
+    if (size == 0) {
+        return {};
+    }
+    std::vector<Results> results(threads);
+    std::vector<std::thread> workers;
+    const char *first = buffer;
+    for (size_t i = 0; i < threads; ++i) {
+        auto last = i + 1 == threads ? buffer + size : buffer + size / threads * (i + 1);
+        last = std::max(last, first);
+        auto end = static_cast<const char *>(memchr(last, '\n', buffer + size - last));
+        last = end ? end + 1 : buffer + size;
+        workers.emplace_back([=, &results] { analyze(first, last, type, bits, results[i]); });
+        first = last;
+    }
+    Results total;
+    for (size_t i = 0; i < threads; ++i) {
+        workers[i].join();
+        total += results[i];
+    }
+    return total;
+}
+
+void print(size_t bits, const Summary &summary) {
+    auto values = static_cast<double>(summary.values);
+    auto san = static_cast<double>(summary.san);
+    printf("\n%zu bit: %llu values (%llu negative)\n", bits,
+           static_cast<unsigned long long>(summary.values),
+           static_cast<unsigned long long>(summary.negative));
+    printf("  %-20s %15s %8s %8s\n", "format", "bytes", "average", "vs san");
+    auto row = [&](const char *name, uint64_t bytes) {
+        printf("  %-20s %15llu %8.2f %8.2f\n", name, static_cast<unsigned long long>(bytes),
+               static_cast<double>(bytes) / values, static_cast<double>(bytes) / san);
+    };
+    row("san", summary.san);
+    row("san (unsigned)", summary.sanUnsigned);
+    row("input", summary.input);
+    row("hex", summary.hex);
+    row("decimal", summary.decimal);
+    row("base64", summary.base64);
+    row("base64 (unpadded)", summary.base64Unpadded);
+    printf("  %-6s %15s %8s\n", "length", "values", "share");
+    for (size_t length = 1; length <= maxLength(bits); ++length) {
+        auto count = summary.lengths[length];
+        printf("  %-6zu %15llu %7.2f%%\n", length, static_cast<unsigned long long>(count),
+               100.0 * static_cast<double>(count) / values);
+    }
+}
+
+bool option(const char *arg, const char *name, std::string &value) {
+    auto length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = arg + length + 1;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    auto type = Type::AUTO;
+    size_t bits = 0;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (option(argv[i], "--type", value)) {
+            const char *names[] = {"auto", "int", "ip", "mac", "uuid"};
+            auto it = std::find(std::begin(names), std::end(names), value);
+            if (it == std::end(names)) {
+                std::cerr << "unknown type " << value << "\n" << usage;
+                return 2;
+            }
+            type = static_cast<Type>(it - names);
+        } else if (option(argv[i], "--bits", value)) {
+            bits = std::strtoul(value.c_str(), nullptr, 10);
+            if (std::find(widths, std::end(widths), bits) == std::end(widths)) {
+                std::cerr << "unsupported width " << value << "\n" << usage;
+                return 2;
+            }
+        } else if (option(argv[i], "--threads", value)) {
+            threads = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+        } else if (path == nullptr && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            path = argv[i];
+        } else {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << usage;
+        return 2;
+    }
+
+    // map the file, or read stdin into memory
+    std::string input;
+    const char *buffer = nullptr;
+    size_t size = 0;
+    void *mapped = MAP_FAILED;
+    if (strcmp(path, "-") == 0) {
+        input.assign(std::istreambuf_iterator<char>(std::cin), {});
+        buffer = input.data();
+        size = input.size();
+    } else {
+        auto fd = open(path, O_RDONLY);
+        struct stat status {};
+        if (fd < 0 || fstat(fd, &status) != 0) {
+            perror(path);
+            return 1;
+        }
+        size = static_cast<size_t>(status.st_size);
+        if (size != 0) {
+            mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                perror(path);
+                return 1;
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            buffer = static_cast<const char *>(mapped);
+        }
+        close(fd);
+    }
+
+    auto results = analyze(buffer, size, type, bits, threads);
+    for (size_t i = 0; i < std::size(widths); ++i) {
+        if (results.summaries[i].values != 0) {
+            print(widths[i], results.summaries[i]);
+        }
+    }
+    if (results.skipped != 0) {
+        printf("\nskipped %llu lines that are no values (of the given width)\n",
+               static_cast<unsigned long long>(results.skipped));
+    }
+    if (mapped != MAP_FAILED) {
+        munmap(mapped, size);
+    }
+    return 0;
+}